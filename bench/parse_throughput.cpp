@@ -0,0 +1,66 @@
+#include "json.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace
+{
+    /** It returns an array of count records mixing strings, integers, decimals, literals and nesting. */
+    std::string make_document(size_t count)
+    {
+        std::string text = "[";
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (i)
+                text += ",\n";
+            text += "{\"id\": " + std::to_string(i) +
+                    ", \"name\": \"item \\\"" + std::to_string(i) + "\\\" caf\\u00e9\"" +
+                    ", \"price\": " + std::to_string(i % 1000) + "." + std::to_string(i % 97) +
+                    ", \"ratio\": -1.5e-" + std::to_string(i % 20) +
+                    ", \"active\": " + (i % 2 ? "true" : "false") +
+                    ", \"parent\": null" +
+                    ", \"tags\": [\"a\", \"b\", " + std::to_string(i % 7) + "]}";
+        }
+        text += "]";
+        return text;
+    }
+
+    template <typename F>
+    void measure(const char *name, const std::string &text, int rounds, F f)
+    {
+        f(); // warm up
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < rounds; ++i)
+            f();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        double mb = double(text.size()) * rounds / (1024.0 * 1024.0);
+        std::printf("%-16s %8.1f MB/s\n", name, mb / elapsed.count());
+    }
+}
+
+int main(int argc, char **argv)
+{
+    size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20000;
+    int rounds = argc > 2 ? std::atoi(argv[2]) : 10;
+    const std::string text = make_document(count);
+    std::printf("%zu records, %zu bytes, %d rounds\n", count, text.size(), rounds);
+
+    size_t sink = 0;
+    measure("validate", text, rounds, [&]
+            { sink += ax::Json::is_valid(text); });
+    measure("parse", text, rounds, [&]
+            { sink += (ax::Json::parse_str(text).get_ptr(0) != nullptr); });
+    measure("parse lazy", text, rounds, [&]
+            { sink += (ax::Json::parse_str(text, {.lazy_numbers = true}).get_ptr(0) != nullptr); });
+    measure("parse raw", text, rounds, [&]
+            { sink += (ax::Json::parse_str(text, {.retain_raw = true}).get_ptr(0) != nullptr); });
+    measure("parse chunked", text, rounds, [&]
+            {
+                ax::JsonParser parser;
+                for (size_t i = 0; i < text.size(); i += 4096)
+                    parser.feed(std::string_view(text).substr(i, 4096));
+                sink += parser.finish() && ax::Json(parser.handler().result()).get_ptr(0) != nullptr; });
+    return sink ? 0 : 1;
+}
@@ -1,11 +1,17 @@
 #ifndef AX_JSON_SINGLE_INCLUDE_HPP
 #define AX_JSON_SINGLE_INCLUDE_HPP
 
+#include <version>
 #include <memory>
+#include <new>
 #include <type_traits>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <map>
+#include <memory_resource>
+#include <unordered_map>
+#include <cstdint>
 #include <vector>
 #include <exception>
 #include <iostream>
@@ -14,14 +20,212 @@
 #include <functional>
 #include <sstream>
 #include <fstream>
+#include <stdexcept>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <array>
+#include <span>
+#include <algorithm>
+#include <thread>
+#include <future>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <atomic>
+#include <coroutine>
+#include <utility>
+#include <variant>
+#include <tuple>
+#include <bit>
+#include <limits>
+#include <cmath>
+#include <cstdlib>
+#ifdef __cpp_lib_expected
+#include <expected>
+#endif
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+#define AX_JSON_THROW(exception) throw exception
+#define AX_JSON_TRY try
+#define AX_JSON_CATCH(exception) catch (exception)
+#else
+// Without exceptions, errors that would throw abort instead. Use the try_ functions for untrusted input.
+#define AX_JSON_THROW(exception) std::abort()
+#define AX_JSON_TRY if (true)
+#define AX_JSON_CATCH(exception) if (false)
+#endif
+#if __has_include(<unistd.h>)
+#include <unistd.h>
+#include <cerrno>
+#endif
+#if __has_include(<sys/uio.h>)
+#include <sys/uio.h>
+#include <climits>
+#endif
+#if __has_include(<unistd.h>) && __has_include(<fcntl.h>) && __has_include(<sys/stat.h>)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <system_error>
+#define AX_JSON_HAS_POSIX_IO
+#endif
+#if defined(AX_JSON_HAS_POSIX_IO) && defined(__linux__) && __has_include(<linux/io_uring.h>) && __has_include(<sys/syscall.h>) && __has_include(<sys/mman.h>) && !defined(AX_JSON_NO_IO_URING)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#define AX_JSON_HAS_IO_URING
+#endif
+#if (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)) && !defined(AX_JSON_NO_SIMD)
+#include <emmintrin.h>
+#define AX_JSON_HAS_SSE2
+#endif
 
 namespace ax
 {
+    struct ParseError
+    {
+        /**
+         * The ParseError struct describes why and where a text is not well-formed JSON.
+         * The offset is in bytes from the start of the text, line and column start at 1 and the column counts bytes.
+         */
+        enum class Kind : unsigned char
+        {
+            UnexpectedCharacter,
+            UnexpectedEnd,
+            TrailingCharacters,
+            InvalidString, // unescaped control character, bad escape sequence or lone surrogate
+            InvalidNumber,
+            InvalidLiteral
+        };
+        Kind kind = Kind::UnexpectedCharacter;
+        size_t offset = 0;
+        size_t line = 1;
+        size_t column = 1;
+
+        /**
+         * It finds the line and column of offset in text.
+         */
+        static ParseError locate(std::string_view text, Kind kind, size_t offset)
+        {
+            ParseError error{kind, offset};
+            text = text.substr(0, offset);
+            for (size_t pos = text.find('\n'); pos != std::string_view::npos; pos = text.find('\n', pos + 1))
+            {
+                ++error.line;
+                error.column = offset - pos;
+            }
+            if (error.line == 1)
+                error.column = offset + 1;
+            return error;
+        }
+        const char *message() const
+        {
+            switch (kind)
+            {
+            case Kind::UnexpectedEnd:
+                return "Unexpected end of JSON";
+            case Kind::TrailingCharacters:
+                return "Trailing characters after JSON";
+            case Kind::InvalidString:
+                return "Invalid JSON string";
+            case Kind::InvalidNumber:
+                return "Invalid JSON number";
+            case Kind::InvalidLiteral:
+                return "Invalid JSON literal";
+            default:
+                return "Unexpected character in JSON";
+            }
+        }
+    };
+
     class MalformedJson : public std::exception
     {
+    private:
+        std::optional<ParseError> _error;
+
+    public:
+        MalformedJson() = default;
+        MalformedJson(ParseError error) : _error(error) {}
+        /**
+         * The details of the error, when known.
+         */
+        const std::optional<ParseError> &error() const { return _error; }
+        const char *what() const noexcept override { return _error ? _error->message() : "Malformed JSON"; }
+    };
+
+    struct ParseOptions
+    {
+        /**
+         * Every container keeps its span of the source text, and is written as that text while it is not modified,
+         * whatever the output format. Modifications through Json::operator[] and transform discard the spans along their path.
+         * Subtrees obtained through const accessors such as at, find or find_first must not be modified, or call discard_raw first.
+         */
+        bool retain_raw = false;
+        /**
+         * Numbers keep their original text instead of being converted while parsing: to<long>() and to<double>() convert them
+         * on first use and cache the result, and they are written back exactly as they were.
+         */
+        bool lazy_numbers = false;
+        /**
+         * Identical values and subtrees share one frozen node, see Json::deduplicate.
+         */
+        bool deduplicate = false;
+    };
+
+#ifdef __cpp_lib_expected
+    template <typename T, typename E>
+    using Expected = std::expected<T, E>;
+    template <typename E>
+    using Unexpected = std::unexpected<E>;
+#else
+    template <typename E>
+    class Unexpected
+    {
+        /**
+         * The Unexpected class wraps an error to construct an Expected, like std::unexpected.
+         */
+    private:
+        E _error;
+
+    public:
+        explicit Unexpected(E error) : _error(std::move(error)) {}
+        E &error() { return _error; }
+    };
+
+    template <typename T, typename E>
+    class Expected
+    {
+        /**
+         * The Expected class holds either a value or an error, like std::expected, which needs C++23.
+         */
+    private:
+        std::variant<T, E> _storage;
+
     public:
-        const char *what() const noexcept override { return "Malformed JSON"; }
+        Expected(T value) : _storage(std::in_place_index<0>, std::move(value)) {}
+        Expected(Unexpected<E> error) : _storage(std::in_place_index<1>, std::move(error.error())) {}
+        bool has_value() const { return _storage.index() == 0; }
+        explicit operator bool() const { return has_value(); }
+        T &value()
+        {
+            if (!has_value())
+                AX_JSON_THROW(std::logic_error("Expected has no value"));
+            return std::get<0>(_storage);
+        }
+        const T &value() const
+        {
+            if (!has_value())
+                AX_JSON_THROW(std::logic_error("Expected has no value"));
+            return std::get<0>(_storage);
+        }
+        T &operator*() { return std::get<0>(_storage); }
+        const T &operator*() const { return std::get<0>(_storage); }
+        T *operator->() { return &std::get<0>(_storage); }
+        const T *operator->() const { return &std::get<0>(_storage); }
+        const E &error() const { return std::get<1>(_storage); }
+        template <typename U>
+        T value_or(U &&other) const { return has_value() ? std::get<0>(_storage) : static_cast<T>(std::forward<U>(other)); }
     };
+#endif
 
     template <typename T>
     class Proxy
@@ -39,12 +243,24 @@ namespace ax
     private:
         std::shared_ptr<std::shared_ptr<T>> pp;
 
+        void assign(std::shared_ptr<T> object)
+        {
+            if (pp)
+                *pp = std::move(object);
+            else
+                pp = std::make_shared<std::shared_ptr<T>>(std::move(object));
+        }
+
     public:
         /**
          * The Proxy class constructor. It passes the arguments to the constructor of T.
          */
         template <typename... Args>
         Proxy(Args... args) : pp(std::make_shared<std::shared_ptr<T>>(std::make_shared<T>(args...))) {}
+        /**
+         * It creates an empty Proxy, which allocates nothing and references no object until reset.
+         */
+        Proxy(std::nullptr_t) {}
         /**
          * It creates a new Proxy from a shared pointer to an object of class U, which must be a subclass of T.
          */
@@ -54,15 +270,33 @@ namespace ax
          * The Proxy class copy constructor. It creates a new Proxy instance that shares the same object of class T.
          */
         Proxy(const Proxy<T> &other) : pp(other.pp) {}
+        /**
+         * A moved from Proxy is empty.
+         */
+        Proxy(Proxy<T> &&other) noexcept = default;
+        /**
+         * Assignment makes this Proxy object share the cell of the other one, it does not change the object of the former cell.
+         */
+        Proxy &operator=(const Proxy<T> &other) = default;
+        Proxy &operator=(Proxy<T> &&other) noexcept = default;
         /**
          * It constructs a new object of class T and makes all copies of this proxy object reference the new object.
          */
         template <typename... Args>
-        void reset(Args... args) { *pp = std::make_shared<T>(args...); }
+        void reset(Args... args) { assign(std::make_shared<T>(args...)); }
         /**
          * It makes all copies of this proxy object reference the same object as the other proxy object.
          */
-        void reset(const Proxy<T> &other) { *pp = *other.pp; }
+        void reset(const Proxy<T> &other) { assign(*other.pp); }
+        /**
+         * It makes all copies of this proxy object reference object.
+         */
+        void reset(std::shared_ptr<T> object) { assign(std::move(object)); }
+        bool empty() const { return !pp; }
+        /**
+         * It returns a new Proxy that references the same object, but whose reset does not affect this one.
+         */
+        Proxy<T> share() const { return Proxy<T>(*pp); }
         /**
          * It returns a reference to the underlying object of class T.
          */
@@ -75,7 +309,7 @@ namespace ax
          * It returns a pointer to the underlying object of class T, casted to class U.
          */
         template <typename U>
-        U *as() const { return reinterpret_cast<U *>((*pp).get()); }
+        U *as() const { return static_cast<U *>((*pp).get()); }
         /**
          * It returns a new Proxy instance that references a copy of the underlying object of class T.
          */
@@ -91,413 +325,4781 @@ namespace ax
         }
     };
 
-    template <typename T>
-    concept ConvertibleToStdString = requires(T a) { std::to_string(a); };
-
-    class Node
+    class ThreadPool
     {
-    public:
-        virtual ~Node() = default;
-        virtual bool indexable() const { return false; }
-        virtual bool key_indexable() const { return false; }
-        virtual bool is_leaf() const { return false; }
-        virtual std::ostream &dump(std::ostream &os) const { return os; }
-        virtual Node *clone() const { return new Node(*this); }
-        friend std::ostream &operator<<(std::ostream &os, const Node &node)
+        /**
+         * The ThreadPool class runs submitted tasks on a fixed set of worker threads, with work stealing:
+         * a task submitted by a worker goes to the back of that worker's queue, every worker runs its newest tasks first,
+         * and idle workers steal the oldest tasks of the others. Tasks submitted from other threads go to a shared queue.
+         * A task may only wait for other tasks of the same pool through a TaskGroup, which keeps running tasks while it waits.
+         */
+    private:
+        struct Queue
         {
-            return node.dump(os);
-        }
-    };
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+        static inline thread_local ThreadPool *current_pool = nullptr;
+        static inline thread_local size_t current_index = 0;
+        std::vector<std::thread> workers;
+        std::vector<std::unique_ptr<Queue>> queues; // one per worker
+        Queue shared_queue;
+        std::atomic<size_t> queued{0};
+        std::mutex mutex;
+        std::condition_variable available;
+        bool stopping = false;
 
-    class ValueNode : public Node
-    {
-    private:
-        std::function<std::ostream &(std::ostream &, std::string)> _printer;
-        std::optional<std::string> _value;
-        ValueNode() = default;
-        ValueNode(ValueNode const &) = default;
-        ValueNode(std::string value) : _value(value), _printer([](std::ostream &os, std::string value) -> std::ostream &
-                                                               { return os << "\"" << value << "\""; })
+        bool pop(Queue &queue, bool newest, std::function<void()> &task)
         {
+            std::lock_guard lock(queue.mutex);
+            if (queue.tasks.empty())
+                return false;
+            if (newest)
+            {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            }
+            else
+            {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+            queued.fetch_sub(1);
+            return true;
         }
-        ValueNode(const char *value) : ValueNode(std::string(value)) {}
-        template <ConvertibleToStdString T>
-        ValueNode(T value) : _value(std::to_string(value)), _printer(
-                                                                [](std::ostream &os, std::string value) -> std::ostream &
-                                                                { return os << value; })
+        bool take(std::function<void()> &task)
         {
+            bool is_worker = current_pool == this;
+            if (is_worker && pop(*queues[current_index], true, task))
+                return true;
+            if (pop(shared_queue, false, task))
+                return true;
+            for (size_t i = 1; i <= queues.size(); ++i)
+            {
+                size_t victim = ((is_worker ? current_index : 0) + i) % queues.size();
+                if (pop(*queues[victim], false, task))
+                    return true;
+            }
+            return false;
         }
-        ValueNode(bool value) : _value(value ? "1" : "0"), _printer([](std::ostream &os, std::string value) -> std::ostream &
-                                                                    { return os << (std::stoi(value) ? "true" : "false"); })
+        void work(size_t index)
         {
+            current_pool = this;
+            current_index = index;
+            std::function<void()> task;
+            while (true)
+            {
+                if (take(task))
+                {
+                    task();
+                    task = nullptr;
+                    continue;
+                }
+                std::unique_lock lock(mutex);
+                available.wait(lock, [this]
+                               { return stopping || queued > 0; });
+                if (stopping && queued == 0)
+                    return;
+            }
         }
 
     public:
-        template <typename... Args>
-        static Proxy<Node> proxy(Args... args)
+        explicit ThreadPool(size_t threads = std::max(1u, std::thread::hardware_concurrency()))
         {
-            auto ptr = std::shared_ptr<ValueNode>(new ValueNode(args...));
-            return Proxy<Node>(ptr);
+            threads = std::max<size_t>(threads, 1);
+            for (size_t i = 0; i < threads; ++i)
+                queues.push_back(std::make_unique<Queue>());
+            for (size_t i = 0; i < threads; ++i)
+                workers.emplace_back([this, i]
+                                     { work(i); });
         }
-        bool is_leaf() const override { return true; };
-        std::optional<std::string> value() const { return _value; }
-        std::ostream &dump(std::ostream &os) const override
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+        ~ThreadPool()
         {
-            if (value().has_value())
-                return _printer(os, value().value());
-            return os << "null";
+            {
+                std::lock_guard lock(mutex);
+                stopping = true;
+            }
+            available.notify_all();
+            for (auto &worker : workers)
+                worker.join();
         }
-        virtual ValueNode *clone() const override { return new ValueNode(*this); }
-    };
-
-    class KeyIndexableNodeI : public Node
-    {
-    public:
-        virtual Proxy<Node> operator[](std::string key) = 0;
-        bool key_indexable() const override { return true; }
-    };
-
-    class IndexableNodeI : public Node
-    {
-    public:
-        virtual Proxy<Node> operator[](size_t idx) = 0;
-        bool indexable() const override { return true; }
-        virtual size_t size() const = 0;
-    };
-
-    class ObjectNode : public KeyIndexableNodeI
-    {
-    private:
-        std::map<std::string, Proxy<Node>> children;
-        ObjectNode() = default;
-        ObjectNode(ObjectNode const &) = default;
-
-    public:
-        template <typename... Args>
-        static Proxy<Node> proxy(Args... args)
+        /**
+         * It returns a process wide pool with one worker per hardware thread, created on first use.
+         */
+        static ThreadPool &shared()
         {
-            auto ptr = std::shared_ptr<ObjectNode>(new ObjectNode(args...));
-            return Proxy<Node>(ptr);
+            static ThreadPool pool;
+            return pool;
         }
-        Proxy<Node> operator[](std::string key) override { return children[key]; }
-        std::ostream &dump(std::ostream &os) const override
+        size_t size() const { return workers.size(); }
+        void post(std::function<void()> task)
         {
-            os << "{";
-            for (auto it = children.begin(); it != children.end(); ++it)
+            Queue &queue = current_pool == this ? *queues[current_index] : shared_queue;
+            queued.fetch_add(1);
             {
-                os << "\"" << it->first << "\": ";
-                it->second->dump(os);
-                if (std::next(it) != children.end())
-                    os << ", ";
+                std::lock_guard lock(queue.mutex);
+                queue.tasks.push_back(std::move(task));
             }
-            return os << "}";
-        }
-        virtual ObjectNode *clone() const override
-        {
-            auto clone = new ObjectNode();
-            for (auto &[key, child] : children)
             {
-                clone->children[key] = child.clone();
+                std::lock_guard lock(mutex); // Pairs with the predicate check of sleeping workers
             }
-            return clone;
+            available.notify_one();
+        }
+        template <typename F>
+        std::future<std::invoke_result_t<F>> submit(F task)
+        {
+            auto packaged = std::make_shared<std::packaged_task<std::invoke_result_t<F>()>>(std::move(task));
+            auto future = packaged->get_future();
+            post([packaged]
+                 { (*packaged)(); });
+            return future;
+        }
+        /**
+         * It runs one pending task on the calling thread, if there is any. It returns false otherwise.
+         */
+        bool run_one()
+        {
+            std::function<void()> task;
+            if (!take(task))
+                return false;
+            task();
+            return true;
         }
     };
 
-    class ArrayNode : public IndexableNodeI
+    class TaskGroup
     {
+        /**
+         * The TaskGroup class runs tasks on a ThreadPool and waits for all of them.
+         * While waiting, the calling thread runs pending tasks of the pool itself, so groups can be nested
+         * inside pool tasks (fork/join) without running out of workers. The first exception thrown by a task is rethrown by wait.
+         */
     private:
-        std::vector<Proxy<Node>> children;
-        ArrayNode() = default;
-        ArrayNode(ArrayNode const &) = default;
+        ThreadPool &pool;
+        std::atomic<size_t> pending{0};
+        std::mutex error_mutex;
+        std::exception_ptr error;
 
     public:
-        template <typename... Args>
-        static Proxy<Node> proxy(Args... args)
-        {
-            auto ptr = std::shared_ptr<ArrayNode>(new ArrayNode(args...));
-            return Proxy<Node>(ptr);
-        }
-        Proxy<Node> operator[](size_t idx) override
+        explicit TaskGroup(ThreadPool &pool = ThreadPool::shared()) : pool(pool) {}
+        TaskGroup(const TaskGroup &) = delete;
+        TaskGroup &operator=(const TaskGroup &) = delete;
+        ~TaskGroup()
         {
-            if (idx >= children.size())
-            {
-                return ValueNode::proxy();
-            }
-            return children[idx];
+            while (pending.load(std::memory_order_acquire) > 0)
+                if (!pool.run_one())
+                    std::this_thread::yield();
         }
-        size_t size() const override { return children.size(); }
-        void add_child(Proxy<Node> child) { children.push_back(child); }
-        std::ostream &dump(std::ostream &os) const override
+        template <typename F>
+        void run(F task)
         {
-            os << "[";
-            for (size_t i = 0; i < children.size(); ++i)
-            {
-                children[i]->dump(os);
-                if (i + 1 < children.size())
-                    os << ", ";
-            }
-            return os << "]";
+            pending.fetch_add(1);
+            pool.post([this, task]() mutable
+                      {
+                          AX_JSON_TRY
+                          {
+                              task();
+                          }
+                          AX_JSON_CATCH(...)
+                          {
+                              std::lock_guard lock(error_mutex);
+                              if (!error)
+                                  error = std::current_exception();
+                          }
+                          pending.fetch_sub(1, std::memory_order_release); });
         }
-        virtual ArrayNode *clone() const override
+        void wait()
         {
-            auto clone = new ArrayNode();
-            for (auto &child : children)
-            {
-                clone->children.push_back(child.clone());
-            }
-            return clone;
+            while (pending.load(std::memory_order_acquire) > 0)
+                if (!pool.run_one())
+                    std::this_thread::yield();
+            if (error)
+                std::rethrow_exception(std::exchange(error, nullptr));
         }
     };
 
-    class Json
+#ifdef AX_JSON_HAS_IO_URING
+    class IoUring
     {
+        /**
+         * The IoUring class is a minimal io_uring instance driven through the raw system calls, used for chunked file transfers.
+         * Define AX_JSON_NO_IO_URING to compile it out.
+         */
     private:
-        Proxy<Node> root;
-        static Json parse_recursively(std::string &json, size_t &index)
+        int ring_fd = -1;
+        unsigned entries = 0;
+        void *sq_ring = MAP_FAILED;
+        void *cq_ring = MAP_FAILED;
+        void *sqe_ring = MAP_FAILED;
+        size_t sq_ring_size = 0;
+        size_t cq_ring_size = 0;
+        size_t sqe_ring_size = 0;
+        unsigned *sq_head = nullptr;
+        unsigned *sq_tail = nullptr;
+        unsigned *sq_mask = nullptr;
+        unsigned *sq_array = nullptr;
+        unsigned *cq_head = nullptr;
+        unsigned *cq_tail = nullptr;
+        unsigned *cq_mask = nullptr;
+        io_uring_sqe *sqes = nullptr;
+        io_uring_cqe *cqes = nullptr;
+
+    public:
+        explicit IoUring(unsigned depth = 64)
         {
-            switch (json[index])
+            io_uring_params params{};
+            ring_fd = static_cast<int>(::syscall(__NR_io_uring_setup, depth, &params));
+            if (ring_fd < 0)
+                return;
+            entries = params.sq_entries;
+            sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+            if (single_mmap)
+                sq_ring_size = cq_ring_size = std::max(sq_ring_size, cq_ring_size);
+            sqe_ring_size = params.sq_entries * sizeof(io_uring_sqe);
+            sq_ring = ::mmap(nullptr, sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+            cq_ring = single_mmap ? sq_ring : ::mmap(nullptr, cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_CQ_RING);
+            sqe_ring = ::mmap(nullptr, sqe_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+            if (sq_ring == MAP_FAILED || cq_ring == MAP_FAILED || sqe_ring == MAP_FAILED)
             {
-            case '{':
-                return parse_object(json, index);
-            case '[':
-                return parse_array(json, index);
-            default:
-                return parse_value(json, index);
+                release();
+                return;
             }
+            char *sq = static_cast<char *>(sq_ring);
+            char *cq = static_cast<char *>(cq_ring);
+            sq_head = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+            sq_tail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+            sq_mask = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+            sq_array = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+            cq_head = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+            cq_tail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+            cq_mask = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+            cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+            sqes = static_cast<io_uring_sqe *>(sqe_ring);
         }
-        static Json parse_object(std::string &json, size_t &index)
+        IoUring(const IoUring &) = delete;
+        IoUring &operator=(const IoUring &) = delete;
+        ~IoUring() { release(); }
+        void release()
         {
-            ++index; // Skip opening curly brace
-            Json object;
-            while (json[index] != '}')
-            {
-                std::ostringstream key;
-                if (json[index++] != '"')
-                    throw MalformedJson();
-                while (json[index] != '"')
-                {
-                    key << json[index++];
-                }
-                ++index; // Skip final quote
-                ++index; // Skip colon
-                Json value = parse_recursively(json, index);
-                if (json[index] != '}')
-                    ++index; // Skip comma
-                object[key.str()] = value;
-            }
-            ++index; // Skip closing curly brace
-            return object;
+            if (sqe_ring != MAP_FAILED)
+                ::munmap(sqe_ring, sqe_ring_size);
+            if (cq_ring != MAP_FAILED && cq_ring != sq_ring)
+                ::munmap(cq_ring, cq_ring_size);
+            if (sq_ring != MAP_FAILED)
+                ::munmap(sq_ring, sq_ring_size);
+            sq_ring = cq_ring = sqe_ring = MAP_FAILED;
+            if (ring_fd >= 0)
+                ::close(ring_fd);
+            ring_fd = -1;
         }
-        static Json parse_array(std::string &json, size_t &index)
+        bool valid() const { return ring_fd >= 0; }
+        /**
+         * It returns the ring of the calling thread, created on first use, or nullptr if io_uring is not available.
+         */
+        static IoUring *local()
         {
-            ++index; // Skip opening square bracket
-            Proxy<Node> array = ArrayNode::proxy();
-            while (json[index] != ']')
-            {
-                array.as<ArrayNode>()->add_child(parse_recursively(json, index).root);
-                if (json[index] != ']')
-                    ++index; // Skip comma
-            }
-            ++index; // Skip closing square bracket
-            return Json(array);
+            thread_local IoUring ring;
+            return ring.valid() ? &ring : nullptr;
         }
-        static Json parse_value(std::string &json, size_t &index)
+        /**
+         * It reads (or writes) size bytes of fd from (or to) buffer, starting at file offset 0.
+         * The transfer is split in chunks of chunk_size bytes which are all kept in flight together, up to the ring depth.
+         * on_chunk is called with the index of every chunk as soon as it has been completely transferred.
+         * It returns 0 on success or an errno value.
+         */
+        int transfer(int fd, char *buffer, size_t size, bool write, size_t chunk_size, const std::function<void(size_t)> &on_chunk = {})
         {
-            if (json.substr(index, 4) == "true")
-            {
-                index += 4;
-                return Json(true);
-            }
-            if (json.substr(index, 5) == "false")
+            std::deque<std::pair<size_t, size_t>> pending; // offset and length of the chunks left to submit
+            for (size_t offset = 0; offset < size; offset += chunk_size)
+                pending.emplace_back(offset, std::min(chunk_size, size - offset));
+            std::vector<std::pair<size_t, size_t>> requests;
+            std::vector<size_t> left; // bytes left to transfer in every chunk
+            for (auto &[offset, length] : pending)
+                left.push_back(length);
+            unsigned queued = 0, in_flight = 0;
+            int error = 0;
+            while (!pending.empty() || queued > 0 || in_flight > 0)
             {
-                index += 5;
-                return Json(false);
-            }
-            auto is_number = [](char ch)
-            { return '0' <= ch && ch <= '9'; };
-            if (is_number(json[index]))
-            {
-                std::ostringstream number;
-                bool is_float = false;
-                while (json[index] == '.' || is_number(json[index]))
+                unsigned tail = *sq_tail;
+                while (!pending.empty() && queued + in_flight < entries)
                 {
-                    if (json[index] == '.')
-                        is_float = true;
-                    number << json[index++];
+                    auto [offset, length] = pending.front();
+                    pending.pop_front();
+                    unsigned index = tail & *sq_mask;
+                    io_uring_sqe &sqe = sqes[index];
+                    std::memset(&sqe, 0, sizeof(sqe));
+                    sqe.opcode = write ? IORING_OP_WRITE : IORING_OP_READ;
+                    sqe.fd = fd;
+                    sqe.addr = reinterpret_cast<unsigned long long>(buffer + offset);
+                    sqe.len = static_cast<unsigned>(length);
+                    sqe.off = offset;
+                    sqe.user_data = requests.size();
+                    requests.emplace_back(offset, length);
+                    sq_array[index] = index;
+                    ++tail;
+                    ++queued;
                 }
-                if (is_float)
-                    return Json(std::stof(number.str()));
-                return Json(std::stol(number.str()));
-            }
-            if (json[index++] == '"')
-            {
-                std::ostringstream string;
-                while (json[index] != '"')
+                __atomic_store_n(sq_tail, tail, __ATOMIC_RELEASE);
+                int submitted = static_cast<int>(::syscall(__NR_io_uring_enter, ring_fd, queued, 1, IORING_ENTER_GETEVENTS, nullptr, 0));
+                if (submitted < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY)
                 {
-                    string << json[index++];
+                    // Drop what the kernel did not consume, then wait for what it did
+                    error = errno;
+                    pending.clear();
+                    __atomic_store_n(sq_tail, __atomic_load_n(sq_head, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+                    queued = 0;
+                    if (in_flight == 0)
+                        return error;
+                }
+                if (submitted > 0)
+                {
+                    queued -= submitted;
+                    in_flight += submitted;
+                }
+                unsigned head = *cq_head;
+                for (; head != __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE); ++head)
+                {
+                    const io_uring_cqe &cqe = cqes[head & *cq_mask];
+                    auto [offset, length] = requests[cqe.user_data];
+                    --in_flight;
+                    if (cqe.res == -EINTR || cqe.res == -EAGAIN)
+                        pending.emplace_back(offset, length);
+                    else if (cqe.res < 0 || (cqe.res == 0 && length > 0))
+                    {
+                        error = cqe.res < 0 ? -cqe.res : EIO;
+                        pending.clear();
+                    }
+                    else
+                    {
+                        if (static_cast<size_t>(cqe.res) < length)
+                            pending.emplace_back(offset + cqe.res, length - cqe.res);
+                        if ((left[offset / chunk_size] -= cqe.res) == 0 && on_chunk)
+                            on_chunk(offset / chunk_size);
+                    }
                 }
-                ++index; // Skip last quote
-                return Json(string.str());
+                __atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
             }
-            throw MalformedJson();
+            return error;
         }
+    };
+#endif
 
+#ifdef AX_JSON_HAS_POSIX_IO
+    class AsyncFile
+    {
+        /**
+         * The AsyncFile class moves whole regular files between disk and memory in parallel chunks, without blocking the caller.
+         * Transfers go through the io_uring of a pool thread when the kernel supports it, otherwise every chunk is a pread/pwrite task on the pool.
+         * When reading, on_data receives the file contents in order, piece by piece as soon as they are contiguous;
+         * it is never called concurrently. The done callback then runs with either the data or an exception.
+         */
     public:
-        Json() : root(ObjectNode::proxy()) {}
-        Json(const Json &other) : root(other.root) {}
-        Json(Proxy<Node> root) : root(root) {}
-        template <ConvertibleToStdString T>
-        Json(T value) : root(ValueNode::proxy(value)) {}
-        template <ConvertibleToStdString T>
-        Json(std::vector<T> value)
+        static constexpr size_t chunk_size = 1 << 20;
+        using DataCallback = std::function<void(std::string_view data)>;
+        using Callback = std::function<void(std::string &&data, std::exception_ptr error)>;
+
+    private:
+        struct Transfer
         {
-            auto array = ArrayNode::proxy();
-            for (T &item : value)
+            int fd = -1;
+            bool write = false;
+            std::string data;
+            std::atomic<int> error{0};
+            DataCallback on_data;
+            Callback done;
+            std::mutex order;
+            std::vector<bool> arrived;
+            size_t delivered = 0;
+            bool delivering = false;
+            ~Transfer()
             {
-                array.as<ArrayNode>()->add_child(ValueNode::proxy(item));
+                if (fd >= 0)
+                    ::close(fd);
             }
-            root.reset(array);
-        }
-        Json(std::initializer_list<std::pair<std::string, Json>> list)
-        {
-            Proxy<Node> object = ObjectNode::proxy();
-            for (auto &pair : list)
-                object.as<ObjectNode>()->operator[](pair.first).reset(pair.second.root);
-            root.reset(object);
-        }
-        Json(std::string value) : root(ValueNode::proxy(value)) {}
-        Json(const char *value) : root(ValueNode::proxy(value)) {}
-        Json(bool value) : root(ValueNode::proxy(value)) {}
-        Json clone() const
-        {
-            return Json(root.clone());
-        }
-        static Json array(std::initializer_list<Json> list)
-        {
-            std::vector<Json> vec(list);
-            return Json::array(vec);
-        }
-        static Json array(std::vector<Json> list)
-        {
-            Proxy<Node> array = ArrayNode::proxy();
-            for (auto &elem : list)
-                array.as<ArrayNode>()->add_child(elem.root);
-            return Json(array);
-        }
-        Json operator[](std::string key)
-        {
-            if (root->key_indexable())
-                return root.as<KeyIndexableNodeI>()->operator[](key);
-            return Json();
-        }
-        Json operator[](size_t idx)
-        {
-            if (root->indexable())
-                return root.as<IndexableNodeI>()->operator[](idx);
-            return Json();
-        }
-        Json operator=(Json other)
-        {
-            root.reset(other.root);
-            return *this;
-        }
-        Json operator=(std::string value)
-        {
-            root.reset(ValueNode::proxy(value));
-            return *this;
-        }
-        Json operator=(const char *value)
-        {
-            root.reset(ValueNode::proxy(value));
-            return *this;
-        }
-        template <ConvertibleToStdString T>
-        Json operator=(std::vector<T> value)
-        {
-            auto array = ArrayNode::proxy();
-            for (T &item : value)
+            void finish(int code)
             {
-                array.as<ArrayNode>()->add_child(ValueNode::proxy(item));
+                if (fd >= 0)
+                    ::close(fd);
+                fd = -1;
+                if (code)
+                    done({}, std::make_exception_ptr(std::system_error(code, std::generic_category())));
+                else
+                    done(std::move(data), nullptr);
             }
-            root.reset(array);
-            return *this;
-        }
-        template <ConvertibleToStdString T>
-        Json operator=(T value)
-        {
-            root.reset(ValueNode::proxy(value));
-            return *this;
-        }
-        template <typename T>
-        std::optional<T> to() const;
-        template <>
-        std::optional<long> to<long>() const
-        {
-            std::optional<int> result;
-            if (root->is_leaf())
+            // It records that chunk index has been transferred. The first thread to find the next chunks in order delivers them.
+            void arrive(size_t index)
             {
-                std::optional<std::string> s = root.as<ValueNode>()->value();
-                if (s.has_value())
                 {
-                    try
+                    std::lock_guard lock(order);
+                    arrived[index] = true;
+                    if (delivering)
+                        return;
+                    delivering = true;
+                }
+                while (true)
+                {
+                    size_t from, to;
                     {
-                        result = std::stol(s.value());
+                        std::lock_guard lock(order);
+                        from = delivered;
+                        while (delivered < arrived.size() && arrived[delivered])
+                            ++delivered;
+                        to = delivered;
+                        if (from == to)
+                        {
+                            delivering = false;
+                            return;
+                        }
                     }
-                    catch (std::invalid_argument &e)
+                    if (on_data && error == 0)
+                        on_data(std::string_view(data).substr(from * chunk_size, (to - from) * chunk_size));
+                    if (to == arrived.size())
                     {
+                        finish(error);
+                        return;
                     }
                 }
             }
-            return result;
-        }
-        template <>
-        std::optional<double> to<double>() const
+        };
+
+        static void chunk(const std::shared_ptr<Transfer> &transfer, size_t index)
         {
-            std::optional<double> result;
-            if (root->is_leaf())
+            size_t offset = index * chunk_size;
+            size_t length = std::min(chunk_size, transfer->data.size() - offset);
+            while (length > 0 && transfer->error == 0)
             {
-                std::optional<std::string> s = root.as<ValueNode>()->value();
-                if (s.has_value())
+                char *buffer = transfer->data.data() + offset;
+                ssize_t done = transfer->write ? ::pwrite(transfer->fd, buffer, length, offset) : ::pread(transfer->fd, buffer, length, offset);
+                if (done < 0 && errno == EINTR)
+                    continue;
+                if (done <= 0)
                 {
-                    try
-                    {
-                        result = std::stod(s.value());
-                    }
-                    catch (std::invalid_argument &e)
-                    {
-                    }
+                    transfer->error = done < 0 ? errno : EIO;
+                    break;
                 }
+                offset += done;
+                length -= done;
             }
-            return result;
+            transfer->arrive(index);
         }
-        template <>
-        std::optional<int> to<int>() const { return to<long>(); }
-        template <>
-        std::optional<short> to<short>() const { return to<long>(); }
-        template <>
-        std::optional<float> to<float>() const { return to<double>(); }
-        template <>
-        std::optional<std::string> to<std::string>() const
+        static void start(const std::shared_ptr<Transfer> &transfer, const std::string &filename, ThreadPool &pool)
         {
-            std::optional<std::string> result;
-            if (root->is_leaf())
+            int flags = transfer->write ? O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC : O_RDONLY | O_CLOEXEC;
+            transfer->fd = ::open(filename.c_str(), flags, 0644);
+            if (transfer->fd < 0)
             {
-                result = root.as<ValueNode>()->value();
+                if (transfer->write)
+                    transfer->finish(errno);
+                else
+                    transfer->done({}, std::make_exception_ptr(std::runtime_error("File not found")));
+                return;
             }
-            return result;
-        }
-        template <typename T>
-        std::optional<std::vector<T>> asVector() const
-        {
-            std::optional<std::vector<T>> result;
-            if (root->indexable())
+            if (!transfer->write)
             {
-                result = std::vector<T>();
-                for (size_t i = 0; i < root.as<IndexableNodeI>()->size(); i++)
+                struct stat info;
+                if (::fstat(transfer->fd, &info) != 0)
                 {
-                    std::optional<T> value = Json(root.as<IndexableNodeI>()->operator[](i)).to<T>();
-                    if (value.has_value())
-                    {
+                    transfer->finish(errno);
+                    return;
+                }
+                transfer->data.resize(info.st_size);
+            }
+            size_t chunks = (transfer->data.size() + chunk_size - 1) / chunk_size;
+            if (chunks == 0)
+            {
+                transfer->finish(0);
+                return;
+            }
+            transfer->arrived.assign(chunks, false);
+#ifdef AX_JSON_HAS_IO_URING
+            if (IoUring *ring = IoUring::local())
+            {
+                int error = ring->transfer(transfer->fd, transfer->data.data(), transfer->data.size(), transfer->write, chunk_size, [&](size_t index)
+                                           { transfer->arrive(index); });
+                if (error)
+                    transfer->finish(error);
+                return;
+            }
+#endif
+            for (size_t i = 0; i < chunks; ++i)
+                pool.submit([transfer, i]
+                            { chunk(transfer, i); });
+        }
+        static void transfer(std::string filename, bool write, std::string data, ThreadPool &pool, DataCallback on_data, Callback done)
+        {
+            auto transfer = std::make_shared<Transfer>();
+            transfer->write = write;
+            transfer->data = std::move(data);
+            transfer->on_data = std::move(on_data);
+            transfer->done = std::move(done);
+            pool.submit([transfer, filename = std::move(filename), &pool]
+                        { start(transfer, filename, pool); });
+        }
+
+    public:
+        static void read(std::string filename, ThreadPool &pool, DataCallback on_data, Callback done)
+        {
+            transfer(std::move(filename), false, {}, pool, std::move(on_data), std::move(done));
+        }
+        static void write(std::string filename, std::string data, ThreadPool &pool, Callback done)
+        {
+            transfer(std::move(filename), true, std::move(data), pool, {}, std::move(done));
+        }
+    };
+#endif
+
+    template <typename T>
+    concept ConvertibleToStdString = requires(T a) { std::to_string(a); };
+
+    /**
+     * The following concepts classify the C++ types that Json::from and Json::get convert to and from JSON.
+     * Other types can be converted by declaring to_json(ax::Json &, const T &) and from_json(const ax::Json &, T &) next to them,
+     * from_json may return bool to report a failure.
+     */
+    template <typename T>
+    concept JsonScalar = std::is_arithmetic_v<T> || std::is_enum_v<T> || std::is_same_v<T, std::string_view>;
+    template <typename T>
+    concept JsonStringLike = std::is_convertible_v<const T &, std::string_view>;
+    template <typename T>
+    concept JsonObjectLike = !JsonStringLike<T> && requires { typename T::key_type; typename T::mapped_type; } &&
+                             std::is_convertible_v<const typename T::key_type &, std::string_view>;
+    template <typename T>
+    concept JsonTupleLike = requires { std::tuple_size<T>::value; };
+    template <typename T>
+    concept JsonArrayLike = !JsonStringLike<T> && !JsonObjectLike<T> && requires(const T &value) { value.begin(); value.end(); };
+    template <typename T>
+    struct IsOptional : std::false_type
+    {
+    };
+    template <typename T>
+    struct IsOptional<std::optional<T>> : std::true_type
+    {
+    };
+
+    class Json;
+
+    template <typename Value>
+    struct Member
+    {
+        /**
+         * The Member struct is a key and a value for Json::object_of, see member. The value is referenced, not copied.
+         */
+        std::string_view key;
+        const Value &value;
+    };
+
+    template <typename Value>
+    Member<Value> member(std::string_view key, const Value &value) { return {key, value}; }
+
+    class Number
+    {
+        /**
+         * The Number class is an exact JSON number. Integers that fit in 64 bits and decimals with at most 15 significant digits
+         * are held inline as int64_t and double, which convert back to the same value. Anything else, such as a 20 digit ID
+         * or a decimal with more digits than a double can hold, is kept as its significant digits and a decimal exponent.
+         */
+    public:
+        enum class Kind : unsigned char
+        {
+            Int64,
+            Double,
+            Decimal
+        };
+
+    private:
+        Kind _kind = Kind::Int64;
+        bool _negative = false; // for Decimal
+        union
+        {
+            int64_t _int = 0;
+            double _double;
+        };
+        int64_t _exponent = 0; // for Decimal: the value is digits * 10^exponent
+        std::string _digits;   // for Decimal: no leading nor trailing zeros
+
+        static constexpr size_t max_exact_digits = 15;
+        static constexpr int64_t max_exponent = int64_t(1) << 58; // larger decimal exponents are saturated to it
+
+    public:
+        /**
+         * Enough room for the text of any Int64 or Double number, see to_chars.
+         */
+        static constexpr size_t max_inline_chars = 32;
+
+        Number(int64_t value = 0) : _kind(Kind::Int64), _int(value) {}
+        Number(double value) : _kind(Kind::Double), _double(value) {}
+        /**
+         * It reads a number in JSON syntax, it returns nothing if text is not one. Negative zero stays negative.
+         * Exponents beyond max_exponent, far out of the range of a double, are saturated to it.
+         */
+        static std::optional<Number> parse(std::string_view text)
+        {
+            const char *begin = text.data(), *end = begin + text.size();
+            size_t sign = !text.empty() && text[0] == '-' ? 1 : 0;
+            if (sign + 1 < text.size() && text[sign] == '0' && '0' <= text[sign + 1] && text[sign + 1] <= '9')
+                return std::nullopt; // leading zeros
+            if (text.find_first_of(".eE") == std::string_view::npos)
+            {
+                int64_t value;
+                auto result = std::from_chars(begin, end, value);
+                if (result.ec == std::errc() && result.ptr == end)
+                    return value == 0 && text[0] == '-' ? Number(-0.0) : Number(value);
+            }
+            Number number;
+            size_t i = 0, n = text.size();
+            auto is_digit = [&](size_t at)
+            { return at < n && '0' <= text[at] && text[at] <= '9'; };
+            number._negative = i < n && text[i] == '-';
+            if (number._negative)
+                ++i;
+            if (!is_digit(i))
+                return std::nullopt;
+            std::string digits;
+            int64_t exponent = 0;
+            for (; is_digit(i); ++i)
+                digits += text[i];
+            if (i < n && text[i] == '.')
+            {
+                if (!is_digit(++i))
+                    return std::nullopt;
+                for (; is_digit(i); ++i, --exponent)
+                    digits += text[i];
+            }
+            if (i < n && (text[i] == 'e' || text[i] == 'E'))
+            {
+                bool negative = ++i < n && text[i] == '-';
+                if (i < n && (negative || text[i] == '+'))
+                    ++i;
+                if (!is_digit(i))
+                    return std::nullopt;
+                int64_t power = 0;
+                for (; is_digit(i); ++i)
+                    power = std::min(power * 10 + (text[i] - '0'), max_exponent);
+                exponent += negative ? -power : power;
+            }
+            if (i != n)
+                return std::nullopt;
+            size_t first = digits.find_first_not_of('0');
+            if (first == std::string::npos)
+                return Number(number._negative ? -0.0 : 0.0);
+            size_t last = digits.find_last_not_of('0');
+            exponent += digits.size() - 1 - last;
+            digits = digits.substr(first, last + 1 - first);
+            if (exponent >= 0 && digits.size() + exponent <= 18)
+            {
+                int64_t value = 0;
+                std::from_chars(digits.data(), digits.data() + digits.size(), value);
+                for (int64_t k = 0; k < exponent; ++k)
+                    value *= 10;
+                return Number(number._negative ? -value : value);
+            }
+            if (digits.size() <= max_exact_digits)
+            {
+                double value;
+                auto result = std::from_chars(begin, end, value);
+                if (result.ec == std::errc() && (value < 0 ? -value : value) >= std::numeric_limits<double>::min())
+                    return Number(value);
+            }
+            number._kind = Kind::Decimal;
+            number._exponent = exponent;
+            number._digits = std::move(digits);
+            return number;
+        }
+        Kind kind() const { return _kind; }
+        bool is_int64() const { return _kind == Kind::Int64; }
+        bool is_double() const { return _kind == Kind::Double; }
+        bool is_decimal() const { return _kind == Kind::Decimal; }
+        /**
+         * The value as an int64_t, if it is an integer in range.
+         */
+        std::optional<int64_t> to_int64() const
+        {
+            if (_kind == Kind::Int64)
+                return _int;
+            if (_kind == Kind::Double && _double >= -0x1p63 && _double < 0x1p63 && static_cast<double>(static_cast<int64_t>(_double)) == _double)
+                return static_cast<int64_t>(_double);
+            return std::nullopt;
+        }
+        /**
+         * The nearest double. It is infinite if the number is out of range.
+         */
+        double to_double() const
+        {
+            if (_kind == Kind::Int64)
+                return static_cast<double>(_int);
+            if (_kind == Kind::Double)
+                return _double;
+            std::string text = to_string();
+            double value = 0;
+            auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+            if (result.ec == std::errc::result_out_of_range)
+                value = _exponent > 0 ? std::numeric_limits<double>::infinity() : 0.0;
+            return _negative ? -std::abs(value) : value;
+        }
+        /**
+         * For Decimal, the significant digits, the exponent and the sign.
+         */
+        std::string_view digits() const { return _digits; }
+        int64_t exponent() const { return _exponent; }
+        bool negative() const { return _kind == Kind::Decimal ? _negative : to_double() < 0; }
+        /**
+         * The shortest JSON text that reads back as the same number.
+         * Decimals are written in plain notation unless that would need more than 21 integer digits or 6 leading zeros.
+         */
+        std::string to_string() const
+        {
+            if (_kind != Kind::Decimal)
+            {
+                char buffer[max_inline_chars];
+                return std::string(buffer, to_chars(buffer, buffer + sizeof(buffer)).ptr);
+            }
+            std::string text = _negative ? "-" : "";
+            int64_t size = static_cast<int64_t>(_digits.size());
+            int64_t point = size + _exponent; // position of the decimal point in the digits
+            if (_exponent >= 0 && point <= 21)
+                text.append(_digits).append(_exponent, '0');
+            else if (_exponent < 0 && point > 0)
+                text.append(_digits, 0, point).append(1, '.').append(_digits, point);
+            else if (_exponent < 0 && point > -6)
+                text.append("0.").append(-point, '0').append(_digits);
+            else
+            {
+                text.append(_digits, 0, 1);
+                if (size > 1)
+                    text.append(1, '.').append(_digits, 1);
+                text.append(1, 'e').append(std::to_string(point - 1));
+            }
+            return text;
+        }
+        /**
+         * It writes the text of to_string into [first, last) like std::to_chars, without allocating for Int64 and Double.
+         */
+        std::to_chars_result to_chars(char *first, char *last) const
+        {
+            if (_kind == Kind::Int64)
+                return std::to_chars(first, last, _int);
+            if (_kind == Kind::Double)
+                return std::to_chars(first, last, _double);
+            std::string text = to_string();
+            if (text.size() > static_cast<size_t>(last - first))
+                return {last, std::errc::value_too_large};
+            return {std::copy(text.begin(), text.end(), first), std::errc()};
+        }
+        friend bool operator==(const Number &a, const Number &b)
+        {
+            if (a._kind == Kind::Decimal || b._kind == Kind::Decimal)
+                return a._kind == b._kind && a._negative == b._negative && a._exponent == b._exponent && a._digits == b._digits;
+            if (a._kind == Kind::Int64 && b._kind == Kind::Int64)
+                return a._int == b._int;
+            auto ai = a.to_int64(), bi = b.to_int64();
+            return ai && bi ? *ai == *bi : a.to_double() == b.to_double();
+        }
+    };
+
+    class OutputBuffer
+    {
+        /**
+         * The OutputBuffer class collects serialized bytes into a fixed size chunk and hands every full chunk to a sink.
+         * Writes larger than a chunk bypass the buffer, so memory usage is bounded by the chunk size.
+         */
+    public:
+        using Sink = std::function<void(const char *, size_t)>;
+        static constexpr size_t default_chunk_size = 64 * 1024;
+        static constexpr size_t min_reference_size = 64;
+
+    private:
+        Sink sink;
+        Sink reference_sink;
+        std::unique_ptr<char[]> buffer;
+        size_t capacity;
+        size_t used = 0;
+
+    public:
+        explicit OutputBuffer(Sink sink, size_t chunk_size = default_chunk_size)
+            : sink(std::move(sink)), buffer(new char[chunk_size ? chunk_size : 1]), capacity(chunk_size ? chunk_size : 1) {}
+        /**
+         * With a reference sink, write_ref hands long byte ranges to it in place instead of copying them,
+         * after flushing the bytes that precede them. The ranges must stay valid until the sink is done with them.
+         */
+        OutputBuffer(Sink sink, Sink reference_sink, size_t chunk_size)
+            : OutputBuffer(std::move(sink), chunk_size) { this->reference_sink = std::move(reference_sink); }
+        OutputBuffer(OutputBuffer &&other) noexcept
+            : sink(std::move(other.sink)), reference_sink(std::move(other.reference_sink)), buffer(std::move(other.buffer)), capacity(other.capacity), used(other.used) { other.used = 0; }
+        OutputBuffer(const OutputBuffer &) = delete;
+        OutputBuffer &operator=(const OutputBuffer &) = delete;
+        /**
+         * The destructor flushes the pending bytes. Call flush explicitly to observe sink errors.
+         */
+        ~OutputBuffer()
+        {
+            AX_JSON_TRY
+            {
+                flush();
+            }
+            AX_JSON_CATCH(...)
+            {
+            }
+        }
+        static OutputBuffer to_stream(std::ostream &os, size_t chunk_size = 4096)
+        {
+            return OutputBuffer([&os](const char *data, size_t size)
+                                { os.write(data, size); },
+                                chunk_size);
+        }
+        static OutputBuffer to_string(std::string &str, size_t chunk_size = 4096)
+        {
+            return OutputBuffer([&str](const char *data, size_t size)
+                                { str.append(data, size); },
+                                chunk_size);
+        }
+        static OutputBuffer to_file(FILE *file, size_t chunk_size = default_chunk_size)
+        {
+            return OutputBuffer([file](const char *data, size_t size)
+                                {
+                                    if (std::fwrite(data, 1, size, file) != size)
+                                        AX_JSON_THROW(std::runtime_error("Write failed")); },
+                                chunk_size);
+        }
+#if __has_include(<unistd.h>)
+        static OutputBuffer to_fd(int fd, size_t chunk_size = default_chunk_size)
+        {
+            return OutputBuffer([fd](const char *data, size_t size)
+                                {
+                                    while (size > 0)
+                                    {
+                                        ssize_t written = ::write(fd, data, size);
+                                        if (written < 0)
+                                        {
+                                            if (errno == EINTR)
+                                                continue;
+                                            AX_JSON_THROW(std::runtime_error("Write failed"));
+                                        }
+                                        data += written;
+                                        size -= written;
+                                    } },
+                                chunk_size);
+        }
+#endif
+        size_t chunk_size() const { return capacity; }
+        void put(char ch)
+        {
+            if (used == capacity)
+                flush();
+            buffer[used++] = ch;
+        }
+        void write(const char *data, size_t size)
+        {
+            if (size > capacity - used)
+            {
+                flush();
+                if (size >= capacity)
+                {
+                    sink(data, size);
+                    return;
+                }
+            }
+            std::memcpy(buffer.get() + used, data, size);
+            used += size;
+        }
+        void write(std::string_view str) { write(str.data(), str.size()); }
+        /**
+         * Same as write, but the bytes may be referenced rather than copied (see the reference sink).
+         */
+        void write_ref(const char *data, size_t size)
+        {
+            if (!reference_sink || size < min_reference_size)
+            {
+                write(data, size);
+                return;
+            }
+            flush();
+            reference_sink(data, size);
+        }
+        void flush()
+        {
+            if (used == 0)
+                return;
+            size_t size = used;
+            used = 0;
+            sink(buffer.get(), size);
+        }
+    };
+
+#if __has_include(<sys/uio.h>)
+    class IoVecOutput
+    {
+        /**
+         * The IoVecOutput class collects serialized output as a list of iovec segments, ready for writev or sendmsg.
+         * Generated bytes (punctuation, numbers, escapes) and strings passed to JsonWriter::key and value are copied into small
+         * scratch blocks, while long strings and raw texts of a Json document are referenced in place: the serialized document
+         * must not be modified or destroyed while the segments are in use.
+         */
+    private:
+        std::vector<std::unique_ptr<char[]>> blocks;
+        size_t block_size;
+        size_t block_capacity = 0; // of the last block, larger than block_size for a larger copy
+        size_t block_used = 0;
+        std::vector<iovec> _segments;
+        OutputBuffer _buffer;
+
+        void copy(const char *data, size_t size)
+        {
+            if (block_capacity - block_used < size)
+            {
+                block_capacity = std::max(block_size, size);
+                blocks.emplace_back(new char[block_capacity]);
+                block_used = 0;
+            }
+            char *target = blocks.back().get() + block_used;
+            std::memcpy(target, data, size);
+            block_used += size;
+            if (!_segments.empty() && static_cast<char *>(_segments.back().iov_base) + _segments.back().iov_len == target)
+                _segments.back().iov_len += size;
+            else
+                _segments.push_back({target, size});
+        }
+        void reference(const char *data, size_t size)
+        {
+            _segments.push_back({const_cast<char *>(data), size});
+        }
+
+    public:
+        explicit IoVecOutput(size_t scratch_size = 4096)
+            : block_size(scratch_size ? scratch_size : 1),
+              _buffer([this](const char *data, size_t size)
+                      { copy(data, size); },
+                      [this](const char *data, size_t size)
+                      { reference(data, size); },
+                      OutputBuffer::min_reference_size * 4) {}
+        IoVecOutput(const IoVecOutput &) = delete;
+        IoVecOutput &operator=(const IoVecOutput &) = delete;
+        /**
+         * It returns the buffer to serialize into, e.g. with Json::dump or a JsonWriter.
+         */
+        OutputBuffer &buffer() { return _buffer; }
+        const std::vector<iovec> &segments()
+        {
+            _buffer.flush();
+            return _segments;
+        }
+        size_t size()
+        {
+            size_t total = 0;
+            for (auto &segment : segments())
+                total += segment.iov_len;
+            return total;
+        }
+        /**
+         * It writes all segments to fd with as few writev calls as possible, resuming after partial writes.
+         */
+        void write_to(int fd)
+        {
+#ifdef IOV_MAX
+            constexpr size_t max_batch = IOV_MAX;
+#else
+            constexpr size_t max_batch = 1024;
+#endif
+            auto &all = segments();
+            std::vector<iovec> batch;
+            size_t index = 0, offset = 0;
+            while (index < all.size())
+            {
+                batch.assign(all.begin() + index, all.begin() + std::min(all.size(), index + max_batch));
+                batch.front().iov_base = static_cast<char *>(batch.front().iov_base) + offset;
+                batch.front().iov_len -= offset;
+                ssize_t written = ::writev(fd, batch.data(), static_cast<int>(batch.size()));
+                if (written < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+                    AX_JSON_THROW(std::runtime_error("Write failed"));
+                }
+                for (size_t left = written; left > 0;)
+                {
+                    size_t remaining = all[index].iov_len - offset;
+                    if (left < remaining)
+                    {
+                        offset += left;
+                        break;
+                    }
+                    left -= remaining;
+                    ++index;
+                    offset = 0;
+                }
+            }
+        }
+    };
+#endif
+
+    enum class JsonFormat : unsigned char
+    {
+        Spaced,  // {"a": 1, "b": 2}, the format of operator<<
+        Compact, // {"a":1,"b":2}
+        Pretty   // one member per line, indented
+    };
+
+    class JsonWriter
+    {
+        /**
+         * The JsonWriter class emits a JSON document piece by piece into an OutputBuffer, without building a Json tree.
+         * Separators are inserted automatically, so values only need to be written in document order.
+         * Node::dump is implemented on top of it, so both produce the same text.
+         */
+    private:
+        static constexpr size_t indent_table_size = 256;
+        // A newline followed by spaces: any indentation is written with one or a few bulk writes from this table.
+        static constexpr auto indent_table = []
+        {
+            std::array<char, indent_table_size + 1> table{};
+            table[0] = '\n';
+            for (size_t i = 1; i < table.size(); ++i)
+                table[i] = ' ';
+            return table;
+        }();
+
+        OutputBuffer &out;
+        std::vector<bool> empty; // one entry per open container, true while nothing has been written into it
+        bool after_key = false;
+        bool pretty;
+        unsigned indent_width;
+        std::string_view comma;
+        std::string_view colon;
+
+        void newline() { indentation(out, empty.size() * indent_width); }
+        void separator()
+        {
+            if (after_key)
+            {
+                after_key = false;
+                return;
+            }
+            if (!empty.empty())
+            {
+                if (empty.back())
+                    empty.back() = false;
+                else
+                    out.write(comma);
+                if (pretty)
+                    newline();
+            }
+        }
+        void open(char ch)
+        {
+            separator();
+            out.put(ch);
+            empty.push_back(true);
+        }
+        void close(char ch)
+        {
+            bool was_empty = empty.back();
+            empty.pop_back();
+            if (pretty && !was_empty)
+                newline();
+            out.put(ch);
+        }
+        // Only referenced strings may be handed to the reference sink in place, caller strings are copied
+        void string(std::string_view str, bool referenced)
+        {
+            static constexpr char hex[] = "0123456789abcdef";
+            auto body = [&](const char *data, size_t size)
+            {
+                if (referenced)
+                    out.write_ref(data, size);
+                else
+                    out.write(data, size);
+            };
+            out.put('"');
+            size_t run = 0;
+            for (size_t i = 0; i < str.size(); ++i)
+            {
+                unsigned char ch = str[i];
+                if (ch >= 0x20 && ch != '"' && ch != '\\')
+                    continue;
+                body(str.data() + run, i - run);
+                run = i + 1;
+                switch (ch)
+                {
+                case '"':
+                    out.write("\\\"", 2);
+                    break;
+                case '\\':
+                    out.write("\\\\", 2);
+                    break;
+                case '\n':
+                    out.write("\\n", 2);
+                    break;
+                case '\r':
+                    out.write("\\r", 2);
+                    break;
+                case '\t':
+                    out.write("\\t", 2);
+                    break;
+                case '\b':
+                    out.write("\\b", 2);
+                    break;
+                case '\f':
+                    out.write("\\f", 2);
+                    break;
+                default:
+                    char escaped[] = {'\\', 'u', '0', '0', hex[ch >> 4], hex[ch & 0xf]};
+                    out.write(escaped, sizeof(escaped));
+                }
+            }
+            body(str.data() + run, str.size() - run);
+            out.put('"');
+        }
+
+    public:
+        /**
+         * It writes a newline followed by spaces.
+         */
+        static void indentation(OutputBuffer &out, size_t spaces)
+        {
+            size_t chunk = std::min(spaces, indent_table_size);
+            out.write(indent_table.data(), chunk + 1);
+            for (spaces -= chunk; spaces > 0; spaces -= chunk)
+            {
+                chunk = std::min(spaces, indent_table_size);
+                out.write(indent_table.data() + 1, chunk);
+            }
+        }
+        /**
+         * The indent is the number of spaces per nesting level, it is only used by JsonFormat::Pretty.
+         */
+        explicit JsonWriter(OutputBuffer &out, JsonFormat format = JsonFormat::Spaced, unsigned indent = 4)
+            : out(out), pretty(format == JsonFormat::Pretty), indent_width(indent),
+              comma(format == JsonFormat::Spaced ? ", " : ","), colon(format == JsonFormat::Compact ? ":" : ": ") {}
+        JsonWriter &begin_object()
+        {
+            open('{');
+            return *this;
+        }
+        JsonWriter &end_object()
+        {
+            close('}');
+            return *this;
+        }
+        JsonWriter &begin_array()
+        {
+            open('[');
+            return *this;
+        }
+        JsonWriter &end_array()
+        {
+            close(']');
+            return *this;
+        }
+        JsonWriter &key(std::string_view key)
+        {
+            separator();
+            string(key, false);
+            out.write(colon);
+            after_key = true;
+            return *this;
+        }
+        /**
+         * Same as key and value, but the string must stay valid until the output is flushed, like verbatim:
+         * long strings are passed by reference to the sink when it supports it. Node::write uses them for the strings of the document.
+         */
+        JsonWriter &referenced_key(std::string_view key)
+        {
+            separator();
+            string(key, true);
+            out.write(colon);
+            after_key = true;
+            return *this;
+        }
+        JsonWriter &referenced_value(std::string_view value)
+        {
+            separator();
+            string(value, true);
+            return *this;
+        }
+        JsonWriter &value(std::nullptr_t)
+        {
+            return raw("null");
+        }
+        JsonWriter &value(bool value)
+        {
+            return raw(value ? "true" : "false");
+        }
+        JsonWriter &value(std::string_view value)
+        {
+            separator();
+            string(value, false);
+            return *this;
+        }
+        JsonWriter &value(const char *value) { return this->value(std::string_view(value)); }
+        JsonWriter &value(const std::string &value) { return this->value(std::string_view(value)); }
+        template <std::integral T>
+            requires(!std::is_same_v<T, bool>)
+        JsonWriter &value(T value)
+        {
+            char buffer[24];
+            auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            return raw(std::string_view(buffer, result.ptr - buffer));
+        }
+        /**
+         * Floating point values are written in the shortest form that reads back as the same value. Non finite values are written as null.
+         */
+        template <std::floating_point T>
+        JsonWriter &value(T value)
+        {
+            if (value != value || value - value != 0)
+                return raw("null");
+            char buffer[Number::max_inline_chars];
+            auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            return raw(std::string_view(buffer, result.ptr - buffer));
+        }
+        JsonWriter &value(const Number &value)
+        {
+            char buffer[Number::max_inline_chars];
+            auto result = value.to_chars(buffer, buffer + sizeof(buffer));
+            return result.ec == std::errc() ? raw(std::string_view(buffer, result.ptr - buffer)) : raw(value.to_string());
+        }
+        /**
+         * It writes a whole Json subtree at the current position.
+         */
+        JsonWriter &value(const Json &json);
+        /**
+         * It makes the writer continue inside depth containers opened elsewhere, so a slice of their elements can be written on its own.
+         * If first is false, the slice starts with a separator as it follows earlier elements.
+         */
+        JsonWriter &nest(size_t depth, bool first)
+        {
+            empty.assign(depth, false);
+            if (depth > 0)
+                empty.back() = first;
+            after_key = false;
+            return *this;
+        }
+        /**
+         * It appends a slice written by a nested writer (see nest) to the current container.
+         */
+        JsonWriter &splice(std::string_view slice)
+        {
+            if (slice.empty())
+                return *this;
+            out.write(slice);
+            if (!empty.empty())
+                empty.back() = false;
+            return *this;
+        }
+        /**
+         * It writes already serialized JSON text verbatim at the current position.
+         */
+        JsonWriter &raw(std::string_view text)
+        {
+            separator();
+            out.write(text);
+            return *this;
+        }
+        /**
+         * Same as raw, but text must stay valid until the output is flushed: large texts are passed by reference to the sink when it supports it.
+         */
+        JsonWriter &verbatim(std::string_view text)
+        {
+            separator();
+            out.write_ref(text.data(), text.size());
+            return *this;
+        }
+        void flush() { out.flush(); }
+    };
+
+    class JsonReformatter
+    {
+        /**
+         * The JsonReformatter class rewrites JSON text in another JsonFormat in one pass over chunks of any size,
+         * without tokenizing values: string bodies and numbers are copied as they are and whitespace is dropped.
+         * The input is assumed to be well-formed (see Json::validate), finish only checks that strings and containers are closed.
+         * Runs of string bytes and of whitespace are scanned 16 bytes at a time with SSE2 when it is available.
+         */
+    private:
+        OutputBuffer &out;
+        bool pretty;
+        unsigned indent_width;
+        std::string_view comma;
+        std::string_view colon;
+        size_t depth = 0;
+        bool in_string = false;
+        bool escape_pending = false; // a chunk ended right after a backslash inside a string
+        bool opened = false;         // a container was just opened, its first element or its end has not been seen yet
+        bool unbalanced = false;
+
+        static bool is_space(char ch) { return ch == ' ' || ch == '\n' || ch == '\r' || ch == '\t'; }
+        static bool is_structural(char ch) { return ch == '{' || ch == '}' || ch == '[' || ch == ']' || ch == ',' || ch == ':' || ch == '"'; }
+        // It returns the first quote or backslash in [p, end), or end
+        static const char *find_string_end(const char *p, const char *end)
+        {
+#ifdef AX_JSON_HAS_SSE2
+            const __m128i quote = _mm_set1_epi8('"'), backslash = _mm_set1_epi8('\\');
+            for (; end - p >= 16; p += 16)
+            {
+                __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+                unsigned mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(block, quote), _mm_cmpeq_epi8(block, backslash)));
+                if (mask)
+                    return p + std::countr_zero(mask);
+            }
+#endif
+            while (p < end && *p != '"' && *p != '\\')
+                ++p;
+            return p;
+        }
+        // It returns the first byte in [p, end) which is not whitespace, or end
+        static const char *skip_spaces(const char *p, const char *end)
+        {
+#ifdef AX_JSON_HAS_SSE2
+            const __m128i space = _mm_set1_epi8(' '), newline = _mm_set1_epi8('\n'), tab = _mm_set1_epi8('\t'), cr = _mm_set1_epi8('\r');
+            for (; end - p >= 16; p += 16)
+            {
+                __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+                __m128i spaces = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, space), _mm_cmpeq_epi8(block, newline)),
+                                              _mm_or_si128(_mm_cmpeq_epi8(block, tab), _mm_cmpeq_epi8(block, cr)));
+                unsigned mask = ~_mm_movemask_epi8(spaces) & 0xffff;
+                if (mask)
+                    return p + std::countr_zero(mask);
+            }
+#endif
+            while (p < end && is_space(*p))
+                ++p;
+            return p;
+        }
+        void newline() { JsonWriter::indentation(out, depth * indent_width); }
+        // It ends the pending opening of a container before an element
+        void element()
+        {
+            if (opened)
+            {
+                opened = false;
+                if (pretty)
+                    newline();
+            }
+        }
+
+    public:
+        explicit JsonReformatter(OutputBuffer &out, JsonFormat format = JsonFormat::Compact, unsigned indent = 4)
+            : out(out), pretty(format == JsonFormat::Pretty), indent_width(indent),
+              comma(format == JsonFormat::Spaced ? ", " : ","), colon(format == JsonFormat::Compact ? ":" : ": ") {}
+        void feed(std::string_view text)
+        {
+            const char *p = text.data(), *end = p + text.size();
+            while (p < end)
+            {
+                if (in_string)
+                {
+                    const char *start = p;
+                    if (escape_pending)
+                    {
+                        escape_pending = false;
+                        ++p;
+                    }
+                    while (true)
+                    {
+                        p = find_string_end(p, end);
+                        if (p == end || *p == '"')
+                            break;
+                        if (++p == end) // Skip the backslash and the escaped character
+                        {
+                            escape_pending = true;
+                            break;
+                        }
+                        ++p;
+                    }
+                    if (p < end)
+                    {
+                        in_string = false;
+                        ++p; // Closing quote
+                    }
+                    out.write(start, p - start);
+                    continue;
+                }
+                p = skip_spaces(p, end);
+                if (p == end)
+                    break;
+                char ch = *p;
+                if ((ch == '}' || ch == ']') && opened)
+                {
+                    opened = false;
+                    --depth;
+                    out.put(ch);
+                    ++p;
+                    continue;
+                }
+                switch (ch)
+                {
+                case '"':
+                    element();
+                    in_string = true;
+                    out.put(ch);
+                    ++p;
+                    break;
+                case '{':
+                case '[':
+                    element();
+                    ++depth;
+                    opened = true;
+                    out.put(ch);
+                    ++p;
+                    break;
+                case '}':
+                case ']':
+                    if (depth == 0)
+                        unbalanced = true;
+                    else
+                        --depth;
+                    if (pretty)
+                        newline();
+                    out.put(ch);
+                    ++p;
+                    break;
+                case ',':
+                    out.write(comma);
+                    if (pretty)
+                        newline();
+                    ++p;
+                    break;
+                case ':':
+                    out.write(colon);
+                    ++p;
+                    break;
+                default:
+                {
+                    element();
+                    const char *start = p;
+                    while (p < end && !is_space(*p) && !is_structural(*p))
+                        ++p;
+                    out.write(start, p - start);
+                }
+                }
+            }
+        }
+        /**
+         * It flushes the output. It returns false if the text ended inside a string or a container, or closed too many containers.
+         */
+        bool finish()
+        {
+            out.flush();
+            return !in_string && depth == 0 && !unbalanced;
+        }
+    };
+
+    /**
+     * It writes text without any whitespace outside strings.
+     */
+    inline bool minify(std::string_view text, OutputBuffer &out)
+    {
+        JsonReformatter reformatter(out, JsonFormat::Compact);
+        reformatter.feed(text);
+        return reformatter.finish();
+    }
+    inline std::string minify(std::string_view text)
+    {
+        std::string result;
+        result.reserve(text.size());
+        OutputBuffer out = OutputBuffer::to_string(result);
+        minify(text, out);
+        return result;
+    }
+    /**
+     * It writes text with one element per line, indented by indent spaces per nesting level, like JsonFormat::Pretty.
+     */
+    inline bool prettify(std::string_view text, OutputBuffer &out, unsigned indent = 4)
+    {
+        JsonReformatter reformatter(out, JsonFormat::Pretty, indent);
+        reformatter.feed(text);
+        return reformatter.finish();
+    }
+    inline std::string prettify(std::string_view text, unsigned indent = 4)
+    {
+        std::string result;
+        OutputBuffer out = OutputBuffer::to_string(result);
+        prettify(text, out, indent);
+        return result;
+    }
+
+    struct RawSpan
+    {
+        /**
+         * The RawSpan struct is the original text of a parsed container. It keeps the whole source text alive.
+         */
+        std::shared_ptr<const std::string> source;
+        std::string_view text;
+    };
+
+    class Arena : public std::pmr::memory_resource
+    {
+        /**
+         * The Arena class hands out memory in order from a few large blocks, for the nodes of a compacted document.
+         * Freed memory is not reused: the blocks are released together when the arena is destroyed.
+         */
+    private:
+        std::mutex mutex;
+        std::pmr::monotonic_buffer_resource buffer;
+
+        void *do_allocate(size_t bytes, size_t alignment) override
+        {
+            std::lock_guard lock(mutex);
+            return buffer.allocate(bytes, alignment);
+        }
+        void do_deallocate(void *, size_t, size_t) override {}
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+
+    public:
+        /**
+         * The first block has initial_size bytes, the next ones grow geometrically.
+         */
+        explicit Arena(size_t initial_size) : buffer(std::max<size_t>(initial_size, 64)) {}
+
+        template <typename T>
+        struct Allocator
+        {
+            /**
+             * The Allocator struct allocates from an arena and keeps it alive, e.g. for the control blocks of the nodes
+             * placed in it: the arena outlives the deallocation of the last control block.
+             */
+            using value_type = T;
+            std::shared_ptr<Arena> arena;
+
+            explicit Allocator(std::shared_ptr<Arena> arena) : arena(std::move(arena)) {}
+            template <typename U>
+            Allocator(const Allocator<U> &other) : arena(other.arena) {}
+            T *allocate(size_t n) { return static_cast<T *>(arena->allocate(n * sizeof(T), alignof(T))); }
+            void deallocate(T *memory, size_t n) { arena->deallocate(memory, n * sizeof(T), alignof(T)); }
+            template <typename U>
+            bool operator==(const Allocator<U> &other) const { return arena == other.arena; }
+        };
+    };
+
+    class Node;
+
+    class NodePool : public std::pmr::memory_resource
+    {
+        /**
+         * The NodePool class recycles the memory of nodes, their control blocks and short strings through per-thread
+         * free lists, one per 16 byte size class up to 256 bytes: once the lists are warm, replacing a value calls neither
+         * malloc nor free. Memory freed on another thread joins the lists of that thread. Larger blocks use the global allocator.
+         * The lists of a thread hold at most max_free_bytes, see also trim.
+         */
+    public:
+        static constexpr size_t max_free_bytes = 1 << 20; // per thread, the rest goes back to the global allocator
+
+    private:
+        static constexpr size_t granule = 16;
+        static constexpr size_t classes = 16;
+
+        struct Block
+        {
+            Block *next;
+        };
+        struct FreeLists
+        {
+            std::array<Block *, classes> heads{};
+            size_t bytes = 0;
+            bool *released;
+            void clear()
+            {
+                for (Block *&head : heads)
+                    while (head)
+                        ::operator delete(std::exchange(head, head->next));
+                bytes = 0;
+            }
+            ~FreeLists()
+            {
+                *released = true;
+                clear();
+            }
+        };
+
+        // The lists of this thread, nullptr while the thread is exiting and they are already destroyed
+        static FreeLists *lists()
+        {
+            thread_local bool released = false;
+            thread_local FreeLists lists{{}, 0, &released};
+            return released ? nullptr : &lists;
+        }
+        static bool pooled(size_t bytes, size_t alignment) { return bytes <= granule * classes && alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__; }
+
+        void *do_allocate(size_t bytes, size_t alignment) override
+        {
+            if (!pooled(bytes, alignment))
+                return ::operator new(bytes, std::align_val_t(alignment));
+            size_t size_class = bytes == 0 ? 0 : (bytes - 1) / granule;
+            FreeLists *free = lists();
+            if (free && free->heads[size_class])
+            {
+                free->bytes -= (size_class + 1) * granule;
+                return std::exchange(free->heads[size_class], free->heads[size_class]->next);
+            }
+            return ::operator new((size_class + 1) * granule);
+        }
+        void do_deallocate(void *memory, size_t bytes, size_t alignment) override
+        {
+            if (!pooled(bytes, alignment))
+            {
+                ::operator delete(memory, std::align_val_t(alignment));
+                return;
+            }
+            size_t size_class = bytes == 0 ? 0 : (bytes - 1) / granule;
+            FreeLists *free = lists();
+            if (!free || free->bytes + (size_class + 1) * granule > max_free_bytes)
+            {
+                ::operator delete(memory);
+                return;
+            }
+            free->bytes += (size_class + 1) * granule;
+            free->heads[size_class] = new (memory) Block{free->heads[size_class]};
+        }
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+
+        template <typename T>
+        struct Release
+        {
+            void operator()(Node *node) const
+            {
+                static_cast<T *>(node)->~T();
+                instance().deallocate(node, sizeof(T), alignof(T));
+            }
+        };
+
+    public:
+        // The pool is never destroyed, nodes may outlive static objects
+        static NodePool &instance()
+        {
+            static NodePool *pool = new NodePool();
+            return *pool;
+        }
+        /**
+         * It constructs a T, a node class, in pooled memory, with its control block.
+         */
+        template <typename T, typename... Args>
+        static std::shared_ptr<Node> make(Args &&...args)
+        {
+            NodePool &pool = instance();
+            struct Guard
+            {
+                NodePool &pool;
+                void *memory;
+                ~Guard()
+                {
+                    if (memory)
+                        pool.deallocate(memory, sizeof(T), alignof(T));
+                }
+            } guard{pool, pool.allocate(sizeof(T), alignof(T))};
+            T *node = new (guard.memory) T(std::forward<Args>(args)...);
+            guard.memory = nullptr;
+            return std::shared_ptr<Node>(node, Release<T>(), std::pmr::polymorphic_allocator<Node>(&pool));
+        }
+        /**
+         * It returns the free blocks of the calling thread to the global allocator, e.g. after releasing many nodes.
+         */
+        static void trim()
+        {
+            if (FreeLists *free = lists())
+                free->clear();
+        }
+    };
+
+    class Node
+    {
+        /**
+         * The Node class is the base of the document tree. It has no virtual methods: every node carries a one-byte type tag,
+         * and write, clone and delete switch on it, so the checks below are inlined and the switches are direct branches.
+         * A bare Node is null.
+         */
+    public:
+        enum class Type : unsigned char
+        {
+            Null,
+            Value,
+            Object,
+            Array
+        };
+
+    private:
+        Type _type = Type::Null;
+        bool _frozen = false;
+
+    protected:
+        explicit Node(Type type) : _type(type) {}
+
+    public:
+        Node() = default;
+        /**
+         * A copy is never frozen.
+         */
+        Node(Node const &other) : _type(other._type) {}
+        /**
+         * It destroys the node as its actual class, which replaces a virtual destructor.
+         */
+        void operator delete(Node *node, std::destroying_delete_t);
+        /**
+         * It runs the destructor of the actual class of node, without releasing its memory.
+         */
+        static void destroy(Node *node);
+        Type type() const { return _type; }
+        bool indexable() const { return _type == Type::Array; }
+        bool key_indexable() const { return _type == Type::Object; }
+        bool is_leaf() const { return _type == Type::Value; }
+        /**
+         * A frozen node may be shared by several places of a document, see Json::deduplicate. It is never modified:
+         * Json copies it on write with thaw, and so do its children, one level at a time.
+         */
+        bool frozen() const { return _frozen; }
+        void freeze() { _frozen = true; }
+        void write(JsonWriter &writer) const;
+        /**
+         * The original text of a container parsed with ParseOptions::retain_raw, empty if there is none or it was discarded.
+         */
+        std::string_view raw() const;
+        void discard_raw();
+        std::ostream &dump(std::ostream &os) const
+        {
+            OutputBuffer out = OutputBuffer::to_stream(os);
+            JsonWriter writer(out);
+            write(writer);
+            out.flush();
+            return os;
+        }
+        Node *clone() const;
+        /**
+         * It returns a shallow copy, whose children are the same nodes in cells of its own.
+         */
+        Node *thaw() const;
+        /**
+         * It returns a copy allocated in arena, whose children are the same cells. The copy keeps the frozen flag.
+         */
+        Node *relocate(std::pmr::memory_resource &arena) const;
+        friend std::ostream &operator<<(std::ostream &os, const Node &node)
+        {
+            return node.dump(os);
+        }
+    };
+
+    class ValueNode : public Node
+    {
+    public:
+        enum class Kind : unsigned char
+        {
+            String,
+            Number,
+            Boolean
+        };
+        /**
+         * Room for the text of a number held as int64_t or double, see text.
+         */
+        using Buffer = std::array<char, Number::max_inline_chars>;
+
+    private:
+        // How the value is held: as text (strings, booleans, lazy and decimal numbers), or as the bits of an int64_t or a double
+        enum class Storage : unsigned char
+        {
+            Text,
+            Int64,
+            Double
+        };
+
+        Kind _kind = Kind::String;
+        Storage _storage = Storage::Text;
+        mutable std::atomic<unsigned char> _converted{0}; // two bits per conversion: 1 when cached, 2 when it failed
+        std::optional<std::pmr::string> _value;
+        uint64_t _number = 0; // the bits of the int64_t or double
+        mutable std::atomic<int64_t> _long{0};
+        mutable std::atomic<uint64_t> _double{0}; // the bits of the double
+        static constexpr unsigned long_shift = 0, double_shift = 2;
+
+        ValueNode() : Node(Type::Value) {}
+        ValueNode(ValueNode const &other)
+            : Node(other), _kind(other._kind), _storage(other._storage), _converted(other._converted.load(std::memory_order_acquire)),
+              _value(other._value), _number(other._number),
+              _long(other._long.load(std::memory_order_relaxed)), _double(other._double.load(std::memory_order_relaxed)) {}
+        ValueNode(ValueNode const &other, std::pmr::memory_resource *arena)
+            : Node(other), _kind(other._kind), _storage(other._storage), _converted(other._converted.load(std::memory_order_acquire)),
+              _number(other._number), _long(other._long.load(std::memory_order_relaxed)), _double(other._double.load(std::memory_order_relaxed))
+        {
+            if (other._value)
+                _value.emplace(*other._value, arena);
+        }
+        ValueNode(Kind kind, std::string_view value) : Node(Type::Value), _kind(kind), _value(std::in_place, value, &NodePool::instance()) {}
+        ValueNode(std::string_view value) : ValueNode(Kind::String, value) {}
+        ValueNode(const char *value) : ValueNode(Kind::String, value) {}
+        template <ConvertibleToStdString T>
+        ValueNode(T value) : Node(Type::Value), _kind(Kind::Number)
+        {
+            if constexpr (std::is_same_v<T, float>)
+            {
+                // The double written like the float, so that 0.1f stays 0.1
+                char buffer[Number::max_inline_chars];
+                double widened = value;
+                std::from_chars(buffer, std::to_chars(buffer, buffer + sizeof(buffer), value).ptr, widened);
+                store(widened);
+            }
+            else if constexpr (std::is_floating_point_v<T>)
+                store(static_cast<double>(value));
+            else if (std::in_range<int64_t>(value))
+                store(static_cast<int64_t>(value));
+            else
+            {
+                char buffer[Number::max_inline_chars];
+                _value.emplace(std::string_view(buffer, std::to_chars(buffer, buffer + sizeof(buffer), value).ptr), &NodePool::instance());
+            }
+        }
+        ValueNode(bool value) : ValueNode(Kind::Boolean, value ? "1" : "0") {}
+        ValueNode(const Number &value) : Node(Type::Value), _kind(Kind::Number)
+        {
+            if (value.is_int64())
+                store(*value.to_int64());
+            else if (value.is_double())
+                store(value.to_double());
+            else
+                _value.emplace(value.to_string(), &NodePool::instance());
+        }
+        friend class NodePool;
+
+        void store(int64_t value)
+        {
+            _storage = Storage::Int64;
+            _number = static_cast<uint64_t>(value);
+        }
+        void store(double value)
+        {
+            _storage = Storage::Double;
+            _number = std::bit_cast<uint64_t>(value);
+        }
+        int64_t stored_int() const { return static_cast<int64_t>(_number); }
+        double stored_double() const { return std::bit_cast<double>(_number); }
+        // The value of number as a long, truncated, nothing if it is out of range
+        static std::optional<long> integer(const Number &number)
+        {
+            if (std::optional<int64_t> value = number.to_int64())
+                return std::in_range<long>(*value) ? std::optional<long>(static_cast<long>(*value)) : std::nullopt;
+            double value = number.to_double();
+            if (value >= static_cast<double>(std::numeric_limits<long>::min()) && value < -static_cast<double>(std::numeric_limits<long>::min()))
+                return static_cast<long>(value);
+            return std::nullopt;
+        }
+
+    public:
+        template <typename... Args>
+        static Proxy<Node> proxy(Args &&...args) { return Proxy<Node>(make(std::forward<Args>(args)...)); }
+        /**
+         * Same as proxy, without the cell: it is meant to reset an existing one.
+         */
+        template <typename... Args>
+        static std::shared_ptr<Node> make(Args &&...args) { return NodePool::make<ValueNode>(std::forward<Args>(args)...); }
+        /**
+         * It makes a number from its JSON text, which is kept as is: it is converted on demand and written back unchanged.
+         */
+        static Proxy<Node> number(std::string_view digits) { return proxy(Kind::Number, digits); }
+        std::optional<std::string> value() const
+        {
+            Buffer buffer;
+            return is_null() ? std::nullopt : std::optional<std::string>(text(buffer));
+        }
+        /**
+         * It converts the value to an integer, the result is cached. Numbers are read with Number::parse, so lazy and eager
+         * numbers agree (1e3 is 1000), and fractions are truncated. Strings that are not JSON numbers are read with std::stol.
+         * It returns nothing for null, when there is no leading number or when it is out of range.
+         */
+        std::optional<long> to_long() const
+        {
+            if (_storage == Storage::Int64)
+                return integer(Number(stored_int()));
+            if (_storage == Storage::Double)
+                return integer(Number(stored_double()));
+            unsigned char state = _converted.load(std::memory_order_acquire) >> long_shift & 3;
+            if (state != 0)
+                return state == 1 ? std::optional<long>(static_cast<long>(_long.load(std::memory_order_relaxed))) : std::nullopt;
+            std::optional<long> result;
+            if (std::optional<Number> number = _value ? Number::parse(*_value) : std::nullopt)
+                result = integer(*number);
+            else if (_kind == Kind::String && _value.has_value())
+            {
+                AX_JSON_TRY
+                {
+                    result = std::stol(std::string(*_value));
+                }
+                AX_JSON_CATCH(std::logic_error &)
+                {
+                }
+            }
+            if (result)
+                _long.store(*result, std::memory_order_relaxed);
+            _converted.fetch_or((result ? 1 : 2) << long_shift, std::memory_order_release);
+            return result;
+        }
+        /**
+         * Same as to_long, to the nearest double, or std::stod for strings. Numbers beyond the range of a double are infinite.
+         */
+        std::optional<double> to_double() const
+        {
+            if (_storage == Storage::Int64)
+                return static_cast<double>(stored_int());
+            if (_storage == Storage::Double)
+                return stored_double();
+            unsigned char state = _converted.load(std::memory_order_acquire) >> double_shift & 3;
+            if (state != 0)
+                return state == 1 ? std::optional<double>(std::bit_cast<double>(_double.load(std::memory_order_relaxed))) : std::nullopt;
+            std::optional<double> result;
+            if (std::optional<Number> number = _value ? Number::parse(*_value) : std::nullopt)
+                result = number->to_double();
+            else if (_kind == Kind::String && _value.has_value())
+            {
+                AX_JSON_TRY
+                {
+                    result = std::stod(std::string(*_value));
+                }
+                AX_JSON_CATCH(std::logic_error &)
+                {
+                }
+            }
+            if (result)
+                _double.store(std::bit_cast<uint64_t>(*result), std::memory_order_relaxed);
+            _converted.fetch_or((result ? 1 : 2) << double_shift, std::memory_order_release);
+            return result;
+        }
+        /**
+         * The exact value of a number, nothing for other values.
+         */
+        std::optional<Number> to_number() const
+        {
+            if (_storage == Storage::Int64)
+                return Number(stored_int());
+            if (_storage == Storage::Double)
+                return Number(stored_double());
+            if (_kind != Kind::Number || !_value.has_value())
+                return std::nullopt;
+            return Number::parse(*_value);
+        }
+        bool is_null() const { return _storage == Storage::Text && !_value.has_value(); }
+        Kind kind() const { return _kind; }
+        /**
+         * The stored text: the string itself, the text of a lazy or decimal number, or "1"/"0" for a boolean.
+         * Empty for null and for numbers held as int64_t or double, use the other overload for those.
+         */
+        std::string_view text() const { return _value ? std::string_view(*_value) : std::string_view(); }
+        /**
+         * Same as text, but numbers held as int64_t or double are written into buffer, in their shortest exact form.
+         */
+        std::string_view text(Buffer &buffer) const
+        {
+            if (_storage == Storage::Int64)
+                return std::string_view(buffer.data(), std::to_chars(buffer.data(), buffer.data() + buffer.size(), stored_int()).ptr);
+            if (_storage == Storage::Double)
+                return std::string_view(buffer.data(), std::to_chars(buffer.data(), buffer.data() + buffer.size(), stored_double()).ptr);
+            return text();
+        }
+        void write(JsonWriter &writer) const
+        {
+            if (is_null())
+            {
+                writer.value(nullptr);
+                return;
+            }
+            switch (_kind)
+            {
+            case Kind::String:
+                writer.referenced_value(text());
+                break;
+            case Kind::Number:
+                if (_storage == Storage::Int64)
+                    writer.value(stored_int());
+                else if (_storage == Storage::Double)
+                    writer.value(stored_double());
+                else
+                    writer.raw(text());
+                break;
+            case Kind::Boolean:
+                writer.value(*_value != "0");
+                break;
+            }
+        }
+        ValueNode *clone() const { return new ValueNode(*this); }
+        ValueNode *thaw() const { return new ValueNode(*this); }
+        ValueNode *relocate(std::pmr::memory_resource &arena) const { return new (arena.allocate(sizeof(ValueNode), alignof(ValueNode))) ValueNode(*this, &arena); }
+    };
+
+    class Shape
+    {
+        /**
+         * The Shape class is the sorted key set of an object. Objects with the same keys share one shape and only store
+         * their values, in the order of the keys, so a key lookup is a search in the shape and an indexed load.
+         * Shapes of at most max_shared_keys keys are interned and never modified. Larger objects own a private shape,
+         * which they modify in place, so that building a big object does not copy its keys at every insertion.
+         */
+    public:
+        static constexpr size_t max_shared_keys = 64;
+
+    private:
+        struct SignatureHash
+        {
+            using is_transparent = void;
+            size_t operator()(std::string_view str) const { return std::hash<std::string_view>()(str); }
+        };
+        struct Registry
+        {
+            std::mutex mutex;
+            std::unordered_map<std::string, std::weak_ptr<Shape>, SignatureHash, std::equal_to<>> shapes;
+        };
+        // A per-thread direct mapped cache in front of the registry, so that repeated shapes take no lock
+        struct CacheEntry
+        {
+            std::string signature;
+            std::weak_ptr<Shape> shape;
+        };
+        static constexpr size_t shard_count = 16;
+        static constexpr size_t cache_size = 64;
+
+        std::vector<std::string> _keys;
+        bool _shared = false;
+
+        // The registry is split into shards by signature hash, each with its own lock. It is never destroyed,
+        // shapes may outlive static objects
+        static Registry &registry(size_t hash)
+        {
+            static Registry *shards = new Registry[shard_count];
+            return shards[hash % shard_count];
+        }
+        // The interning key of a key set: the length and bytes of every key, written into a per-thread buffer
+        template <typename Keys>
+        static const std::string &signature(const Keys &keys)
+        {
+            thread_local std::string buffer;
+            buffer.clear();
+            for (std::string_view key : keys)
+            {
+                uint32_t size = static_cast<uint32_t>(key.size());
+                buffer.append(reinterpret_cast<const char *>(&size), sizeof(size));
+                buffer.append(key);
+            }
+            return buffer;
+        }
+
+    public:
+        Shape() = default;
+        Shape(const Shape &) = delete;
+        ~Shape()
+        {
+            if (!_shared)
+                return;
+            const std::string &key = signature(_keys);
+            Registry &shapes = registry(SignatureHash()(key));
+            std::lock_guard lock(shapes.mutex);
+            auto it = shapes.shapes.find(key);
+            if (it != shapes.shapes.end() && it->second.expired())
+                shapes.shapes.erase(it);
+        }
+        /**
+         * It returns the interned shape of keys, which must be sorted and unique, or a new private one if there are too many.
+         */
+        static std::shared_ptr<Shape> of(const std::vector<std::string_view> &keys)
+        {
+            auto make_keys = [&]
+            { return std::vector<std::string>(keys.begin(), keys.end()); };
+            if (keys.size() > max_shared_keys)
+            {
+                auto shape = std::make_shared<Shape>();
+                shape->_keys = make_keys();
+                return shape;
+            }
+            const std::string &key = signature(keys);
+            size_t hash = SignatureHash()(key);
+            thread_local std::array<CacheEntry, cache_size> cache;
+            CacheEntry &cached = cache[hash / shard_count % cache_size];
+            if (cached.signature == key)
+                if (auto shape = cached.shape.lock())
+                    return shape;
+            std::shared_ptr<Shape> shape;
+            {
+                Registry &shapes = registry(hash);
+                std::lock_guard lock(shapes.mutex);
+                auto it = shapes.shapes.find(key);
+                if (it != shapes.shapes.end())
+                    shape = it->second.lock();
+                if (!shape)
+                {
+                    shape = std::make_shared<Shape>();
+                    shape->_keys = make_keys();
+                    shape->_shared = true;
+                    if (it != shapes.shapes.end())
+                        it->second = shape;
+                    else
+                        shapes.shapes.emplace(key, shape);
+                }
+            }
+            cached.signature = key;
+            cached.shape = shape;
+            return shape;
+        }
+        /**
+         * It returns the shape with the keys of this one and key, which must be missing, at slot.
+         */
+        std::shared_ptr<Shape> with(size_t slot, std::string_view key) const
+        {
+            std::vector<std::string_view> keys(_keys.begin(), _keys.end());
+            keys.insert(keys.begin() + slot, key);
+            return of(keys);
+        }
+        /**
+         * It inserts key at slot in place, for a private shape.
+         */
+        void insert(size_t slot, std::string_view key) { _keys.emplace(_keys.begin() + slot, key); }
+        /**
+         * It returns the slot of key, or the slot where it would be inserted, and whether it is there.
+         */
+        std::pair<size_t, bool> locate(std::string_view key) const
+        {
+            auto it = std::lower_bound(_keys.begin(), _keys.end(), key, [](const std::string &a, std::string_view b)
+                                       { return std::string_view(a) < b; });
+            return {static_cast<size_t>(it - _keys.begin()), it != _keys.end() && *it == key};
+        }
+        const std::string &key(size_t slot) const { return _keys[slot]; }
+        size_t size() const { return _keys.size(); }
+        /**
+         * Whether the shape is interned: it is shared by objects and never changes.
+         */
+        bool shared() const { return _shared; }
+    };
+
+    class ObjectNode : public Node
+    {
+    private:
+        std::shared_ptr<Shape> _shape; // nullptr while the object has no keys
+        std::pmr::vector<Proxy<Node>> values; // in the order of the keys of the shape
+        RawSpan _raw;
+        ObjectNode() : Node(Type::Object), values(&NodePool::instance()) {}
+        ObjectNode(ObjectNode const &) = default;
+        ObjectNode(ObjectNode const &other, std::pmr::memory_resource *arena) : Node(other), _shape(other._shape), values(other.values, arena), _raw(other._raw) {}
+        friend class NodePool;
+
+        void insert_at(size_t slot, std::string_view key, Proxy<Node> child)
+        {
+            if (!_shape)
+                _shape = Shape::of({key});
+            else if (!_shape->shared() && _shape.use_count() == 1)
+                _shape->insert(slot, key);
+            else
+                _shape = _shape->with(slot, key);
+            values.insert(values.begin() + slot, std::move(child));
+        }
+
+    public:
+        template <typename... Args>
+        static Proxy<Node> proxy(Args... args) { return Proxy<Node>(NodePool::make<ObjectNode>(args...)); }
+        Proxy<Node> operator[](std::string_view key)
+        {
+            auto [slot, found] = locate(key);
+            if (!found)
+                insert_at(slot, key, Proxy<Node>());
+            return values[slot];
+        }
+        void insert(std::string_view key, Proxy<Node> child)
+        {
+            auto [slot, found] = locate(key);
+            if (found)
+                values[slot] = std::move(child);
+            else
+                insert_at(slot, key, std::move(child));
+        }
+        /**
+         * It replaces the members with the given ones, in one step: they are sorted and the last of equal keys is kept.
+         */
+        void assign(std::span<std::pair<std::string, Proxy<Node>>> members)
+        {
+            values.clear();
+            if (members.empty())
+            {
+                _shape = nullptr;
+                return;
+            }
+            auto less = [](const auto &a, const auto &b)
+            { return a.first < b.first; };
+            if (!std::is_sorted(members.begin(), members.end(), less))
+                std::stable_sort(members.begin(), members.end(), less);
+            std::vector<std::string_view> keys;
+            keys.reserve(members.size());
+            values.reserve(members.size());
+            for (size_t i = 0; i < members.size(); ++i)
+            {
+                if (i + 1 < members.size() && members[i + 1].first == members[i].first)
+                    continue;
+                keys.push_back(members[i].first);
+                values.push_back(std::move(members[i].second));
+            }
+            _shape = Shape::of(keys);
+        }
+        std::pair<size_t, bool> locate(std::string_view key) const
+        {
+            return _shape ? _shape->locate(key) : std::pair<size_t, bool>(0, false);
+        }
+        const Proxy<Node> *find(std::string_view key) const
+        {
+            auto [slot, found] = locate(key);
+            return found ? &values[slot] : nullptr;
+        }
+        const std::shared_ptr<Shape> &shape() const { return _shape; }
+        const Proxy<Node> &value(size_t slot) const { return values[slot]; }
+
+        class const_iterator
+        {
+            /**
+             * It iterates over the members in key order, as pairs of references to the key and the value.
+             */
+        private:
+            const ObjectNode *object = nullptr;
+            size_t slot = 0;
+
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = std::pair<const std::string &, const Proxy<Node> &>;
+            using difference_type = std::ptrdiff_t;
+            using reference = value_type;
+            using pointer = void;
+
+            const_iterator() = default;
+            const_iterator(const ObjectNode *object, size_t slot) : object(object), slot(slot) {}
+            value_type operator*() const { return {object->_shape->key(slot), object->values[slot]}; }
+            const_iterator &operator++()
+            {
+                ++slot;
+                return *this;
+            }
+            const_iterator operator++(int) { return const_iterator(object, slot++); }
+            const_iterator &operator--()
+            {
+                --slot;
+                return *this;
+            }
+            const_iterator &operator+=(difference_type offset)
+            {
+                slot += offset;
+                return *this;
+            }
+            difference_type operator-(const const_iterator &other) const { return static_cast<difference_type>(slot - other.slot); }
+            bool operator==(const const_iterator &other) const { return slot == other.slot; }
+        };
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator end() const { return const_iterator(this, values.size()); }
+        size_t size() const { return values.size(); }
+        std::string_view raw() const { return _raw.text; }
+        void retain(RawSpan raw) { _raw = std::move(raw); }
+        void discard_raw() { _raw = {}; }
+        void write(JsonWriter &writer) const
+        {
+            if (!_raw.text.empty())
+            {
+                writer.verbatim(_raw.text);
+                return;
+            }
+            writer.begin_object();
+            for (size_t slot = 0; slot < values.size(); ++slot)
+            {
+                writer.referenced_key(_shape->key(slot));
+                values[slot]->write(writer);
+            }
+            writer.end_object();
+        }
+        ObjectNode *clone() const
+        {
+            auto clone = new ObjectNode();
+            clone->_raw = _raw;
+            clone->_shape = _shape;
+            clone->values.reserve(values.size());
+            for (auto &child : values)
+                clone->values.push_back(child.clone());
+            return clone;
+        }
+        ObjectNode *thaw() const
+        {
+            auto copy = new ObjectNode(*this);
+            for (auto &child : copy->values)
+                child = child.share();
+            return copy;
+        }
+        ObjectNode *relocate(std::pmr::memory_resource &arena) const { return new (arena.allocate(sizeof(ObjectNode), alignof(ObjectNode))) ObjectNode(*this, &arena); }
+    };
+
+    class ArrayNode : public Node
+    {
+    private:
+        std::pmr::vector<Proxy<Node>> children;
+        RawSpan _raw;
+        ArrayNode() : Node(Type::Array), children(&NodePool::instance()) {}
+        ArrayNode(ArrayNode const &) = default;
+        ArrayNode(ArrayNode const &other, std::pmr::memory_resource *arena) : Node(other), children(other.children, arena), _raw(other._raw) {}
+        friend class NodePool;
+
+    public:
+        template <typename... Args>
+        static Proxy<Node> proxy(Args... args) { return Proxy<Node>(NodePool::make<ArrayNode>(args...)); }
+        Proxy<Node> operator[](size_t idx)
+        {
+            if (idx >= children.size())
+            {
+                return ValueNode::proxy();
+            }
+            return children[idx];
+        }
+        const Proxy<Node> *at(size_t idx) const
+        {
+            return idx < children.size() ? &children[idx] : nullptr;
+        }
+        size_t size() const { return children.size(); }
+        std::string_view raw() const { return _raw.text; }
+        void retain(RawSpan raw) { _raw = std::move(raw); }
+        void discard_raw() { _raw = {}; }
+        void add_child(Proxy<Node> child) { children.push_back(std::move(child)); }
+        void reserve(size_t size) { children.reserve(size); }
+        using const_iterator = std::pmr::vector<Proxy<Node>>::const_iterator;
+        const_iterator begin() const { return children.begin(); }
+        const_iterator end() const { return children.end(); }
+        void write(JsonWriter &writer) const
+        {
+            if (!_raw.text.empty())
+            {
+                writer.verbatim(_raw.text);
+                return;
+            }
+            writer.begin_array();
+            for (auto &child : children)
+                child->write(writer);
+            writer.end_array();
+        }
+        ArrayNode *clone() const
+        {
+            auto clone = new ArrayNode();
+            clone->_raw = _raw;
+            for (auto &child : children)
+            {
+                clone->children.push_back(child.clone());
+            }
+            return clone;
+        }
+        ArrayNode *thaw() const
+        {
+            auto copy = new ArrayNode(*this);
+            for (auto &child : copy->children)
+                child = child.share();
+            return copy;
+        }
+        ArrayNode *relocate(std::pmr::memory_resource &arena) const { return new (arena.allocate(sizeof(ArrayNode), alignof(ArrayNode))) ArrayNode(*this, &arena); }
+    };
+
+    inline void Node::destroy(Node *node)
+    {
+        switch (node->_type)
+        {
+        case Type::Value:
+            static_cast<ValueNode *>(node)->~ValueNode();
+            break;
+        case Type::Object:
+            static_cast<ObjectNode *>(node)->~ObjectNode();
+            break;
+        case Type::Array:
+            static_cast<ArrayNode *>(node)->~ArrayNode();
+            break;
+        default:
+            node->~Node();
+            break;
+        }
+    }
+
+    inline void Node::operator delete(Node *node, std::destroying_delete_t)
+    {
+        destroy(node);
+        ::operator delete(node);
+    }
+
+    inline void Node::write(JsonWriter &writer) const
+    {
+        switch (_type)
+        {
+        case Type::Value:
+            static_cast<const ValueNode *>(this)->write(writer);
+            break;
+        case Type::Object:
+            static_cast<const ObjectNode *>(this)->write(writer);
+            break;
+        case Type::Array:
+            static_cast<const ArrayNode *>(this)->write(writer);
+            break;
+        default:
+            writer.value(nullptr);
+            break;
+        }
+    }
+
+    inline std::string_view Node::raw() const
+    {
+        switch (_type)
+        {
+        case Type::Object:
+            return static_cast<const ObjectNode *>(this)->raw();
+        case Type::Array:
+            return static_cast<const ArrayNode *>(this)->raw();
+        default:
+            return {};
+        }
+    }
+
+    inline void Node::discard_raw()
+    {
+        if (_type == Type::Object)
+            static_cast<ObjectNode *>(this)->discard_raw();
+        else if (_type == Type::Array)
+            static_cast<ArrayNode *>(this)->discard_raw();
+    }
+
+    inline Node *Node::clone() const
+    {
+        switch (_type)
+        {
+        case Type::Value:
+            return static_cast<const ValueNode *>(this)->clone();
+        case Type::Object:
+            return static_cast<const ObjectNode *>(this)->clone();
+        case Type::Array:
+            return static_cast<const ArrayNode *>(this)->clone();
+        default:
+            return new Node(*this);
+        }
+    }
+
+    inline Node *Node::relocate(std::pmr::memory_resource &arena) const
+    {
+        Node *copy;
+        switch (_type)
+        {
+        case Type::Value:
+            copy = static_cast<const ValueNode *>(this)->relocate(arena);
+            break;
+        case Type::Object:
+            copy = static_cast<const ObjectNode *>(this)->relocate(arena);
+            break;
+        case Type::Array:
+            copy = static_cast<const ArrayNode *>(this)->relocate(arena);
+            break;
+        default:
+            copy = new (arena.allocate(sizeof(Node), alignof(Node))) Node(*this);
+            break;
+        }
+        copy->_frozen = _frozen;
+        return copy;
+    }
+
+    inline Node *Node::thaw() const
+    {
+        switch (_type)
+        {
+        case Type::Value:
+            return static_cast<const ValueNode *>(this)->thaw();
+        case Type::Object:
+            return static_cast<const ObjectNode *>(this)->thaw();
+        case Type::Array:
+            return static_cast<const ArrayNode *>(this)->thaw();
+        default:
+            return new Node(*this);
+        }
+    }
+
+    template <typename Handler>
+    class JsonReader
+    {
+        /**
+         * The JsonReader class is an incremental JSON tokenizer: the text can be fed in chunks of any size as it arrives,
+         * and every complete token is reported to the handler, which must provide
+         * null(), boolean(bool), number(std::string_view), string(std::string_view), key(std::string_view),
+         * begin_object(), end_object(), begin_array() and end_array().
+         * A handler may also provide offset(size_t), called with the offset of every punctuation or value start before its event.
+         * Strings are unescaped before being reported. The views passed to the handler are only valid during the call.
+         */
+    private:
+        enum class State : unsigned char
+        {
+            Value,
+            ObjectFirst,
+            ObjectKey,
+            Colon,
+            ObjectNext,
+            ArrayFirst,
+            ArrayNext,
+            String,
+            Number,
+            Literal,
+            Done,
+            Error
+        };
+        Handler _handler;
+        State state = State::Value;
+        std::vector<char> stack; // '{' or '[' for every open container
+        std::string token;       // the part of a string, number or literal received in previous chunks
+        std::string unescaped;
+        bool is_key = false;
+        bool has_escape = false;
+        bool escape_pending = false; // a chunk ended right after a backslash
+        unsigned char string_bits = 0; // bitwise or of the bytes of the current string, to skip UTF-8 validation for ASCII
+        const char *literal = nullptr;
+        size_t matched = 0;
+        size_t consumed = 0;
+        size_t _error_offset = 0;
+        ParseError::Kind _error_kind = ParseError::Kind::UnexpectedCharacter;
+
+        // Character classes, looked up in one table instead of chains of comparisons
+        enum CharClass : unsigned char
+        {
+            Space = 1,
+            Digit = 2,
+            NumberPart = 4,  // digits, signs, decimal point and exponent marks
+            NumberStart = 8, // digits and minus
+            StringStop = 16, // quote, backslash and control characters, which end a run of plain string bytes
+        };
+        static constexpr auto char_classes = []
+        {
+            std::array<unsigned char, 256> table{};
+            for (char ch : {' ', '\n', '\r', '\t'})
+                table[static_cast<unsigned char>(ch)] |= Space;
+            for (char ch = '0'; ch <= '9'; ++ch)
+                table[static_cast<unsigned char>(ch)] |= Digit | NumberPart | NumberStart;
+            for (char ch : {'-', '+', '.', 'e', 'E'})
+                table[static_cast<unsigned char>(ch)] |= NumberPart;
+            table['-'] |= NumberStart;
+            for (unsigned ch = 0; ch < 0x20; ++ch)
+                table[ch] |= StringStop;
+            table['"'] |= StringStop;
+            table['\\'] |= StringStop;
+            return table;
+        }();
+        static bool has_class(char ch, unsigned char classes) { return char_classes[static_cast<unsigned char>(ch)] & classes; }
+        static bool is_space(char ch) { return has_class(ch, Space); }
+        static bool is_digit(char ch) { return has_class(ch, Digit); }
+        static bool valid_number(std::string_view number)
+        {
+            size_t i = 0, n = number.size();
+            if (i < n && number[i] == '-')
+                ++i;
+            if (i == n)
+                return false;
+            if (number[i] == '0')
+                ++i;
+            else if (is_digit(number[i]))
+                while (i < n && is_digit(number[i]))
+                    ++i;
+            else
+                return false;
+            if (i < n && number[i] == '.')
+            {
+                if (++i == n || !is_digit(number[i]))
+                    return false;
+                while (i < n && is_digit(number[i]))
+                    ++i;
+            }
+            if (i < n && (number[i] == 'e' || number[i] == 'E'))
+            {
+                if (++i < n && (number[i] == '+' || number[i] == '-'))
+                    ++i;
+                if (i == n || !is_digit(number[i]))
+                    return false;
+                while (i < n && is_digit(number[i]))
+                    ++i;
+            }
+            return i == n;
+        }
+        static int hex_value(char ch)
+        {
+            if (is_digit(ch))
+                return ch - '0';
+            if ('a' <= ch && ch <= 'f')
+                return ch - 'a' + 10;
+            if ('A' <= ch && ch <= 'F')
+                return ch - 'A' + 10;
+            return -1;
+        }
+        static bool read_hex4(std::string_view raw, size_t i, unsigned &code)
+        {
+            if (i + 4 > raw.size())
+                return false;
+            code = 0;
+            for (size_t j = i; j < i + 4; ++j)
+            {
+                int digit = hex_value(raw[j]);
+                if (digit < 0)
+                    return false;
+                code = code << 4 | digit;
+            }
+            return true;
+        }
+        /**
+         * It returns true if text is well-formed UTF-8: no overlong forms, surrogates or code points above U+10FFFF.
+         */
+        static bool valid_utf8(std::string_view text)
+        {
+            const unsigned char *p = reinterpret_cast<const unsigned char *>(text.data());
+            const unsigned char *end = p + text.size();
+            while (p < end)
+            {
+                unsigned char ch = *p++;
+                if (ch < 0x80)
+                    continue;
+                size_t length;
+                unsigned char low = 0x80, high = 0xbf; // range of the second byte
+                if (0xc2 <= ch && ch <= 0xdf)
+                    length = 1;
+                else if (0xe0 <= ch && ch <= 0xef)
+                {
+                    length = 2;
+                    if (ch == 0xe0)
+                        low = 0xa0;
+                    else if (ch == 0xed)
+                        high = 0x9f;
+                }
+                else if (0xf0 <= ch && ch <= 0xf4)
+                {
+                    length = 3;
+                    if (ch == 0xf0)
+                        low = 0x90;
+                    else if (ch == 0xf4)
+                        high = 0x8f;
+                }
+                else
+                    return false;
+                if (static_cast<size_t>(end - p) < length || *p < low || *p > high)
+                    return false;
+                for (size_t i = 1; i < length; ++i)
+                    if ((p[i] & 0xc0) != 0x80)
+                        return false;
+                p += length;
+            }
+            return true;
+        }
+        static void append_utf8(std::string &out, unsigned code)
+        {
+            if (code < 0x80)
+                out += static_cast<char>(code);
+            else if (code < 0x800)
+            {
+                out += static_cast<char>(0xc0 | code >> 6);
+                out += static_cast<char>(0x80 | (code & 0x3f));
+            }
+            else if (code < 0x10000)
+            {
+                out += static_cast<char>(0xe0 | code >> 12);
+                out += static_cast<char>(0x80 | (code >> 6 & 0x3f));
+                out += static_cast<char>(0x80 | (code & 0x3f));
+            }
+            else
+            {
+                out += static_cast<char>(0xf0 | code >> 18);
+                out += static_cast<char>(0x80 | (code >> 12 & 0x3f));
+                out += static_cast<char>(0x80 | (code >> 6 & 0x3f));
+                out += static_cast<char>(0x80 | (code & 0x3f));
+            }
+        }
+        // It decodes the escape sequences of a string body into unescaped
+        bool unescape(std::string_view raw)
+        {
+            unescaped.clear();
+            for (size_t i = 0; i < raw.size(); ++i)
+            {
+                if (raw[i] != '\\')
+                {
+                    unescaped += raw[i];
+                    continue;
+                }
+                switch (raw[++i])
+                {
+                case '"':
+                case '\\':
+                case '/':
+                    unescaped += raw[i];
+                    break;
+                case 'b':
+                    unescaped += '\b';
+                    break;
+                case 'f':
+                    unescaped += '\f';
+                    break;
+                case 'n':
+                    unescaped += '\n';
+                    break;
+                case 'r':
+                    unescaped += '\r';
+                    break;
+                case 't':
+                    unescaped += '\t';
+                    break;
+                case 'u':
+                {
+                    unsigned code;
+                    if (!read_hex4(raw, i + 1, code))
+                        return false;
+                    i += 4;
+                    if (0xdc00 <= code && code <= 0xdfff)
+                        return false;
+                    if (0xd800 <= code && code <= 0xdbff)
+                    {
+                        unsigned low;
+                        if (i + 2 >= raw.size() || raw[i + 1] != '\\' || raw[i + 2] != 'u' || !read_hex4(raw, i + 3, low) || low < 0xdc00 || low > 0xdfff)
+                            return false;
+                        i += 6;
+                        code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+                    }
+                    append_utf8(unescaped, code);
+                    break;
+                }
+                default:
+                    return false;
+                }
+            }
+            return true;
+        }
+        bool fail(size_t offset, ParseError::Kind kind)
+        {
+            state = State::Error;
+            _error_offset = offset;
+            _error_kind = kind;
+            return false;
+        }
+        // It moves to the state following a complete value
+        void complete()
+        {
+            if (stack.empty())
+                state = State::Done;
+            else
+                state = stack.back() == '{' ? State::ObjectNext : State::ArrayNext;
+        }
+        bool end_string(std::string_view raw)
+        {
+            std::string_view value = raw;
+            if ((string_bits & 0x80) && !valid_utf8(raw))
+                return false;
+            string_bits = 0;
+            if (has_escape)
+            {
+                if (!unescape(raw))
+                    return false;
+                value = unescaped;
+            }
+            if (is_key)
+            {
+                _handler.key(value);
+                state = State::Colon;
+            }
+            else
+            {
+                _handler.string(value);
+                complete();
+            }
+            token.clear();
+            has_escape = false;
+            return true;
+        }
+        bool end_number(std::string_view number)
+        {
+            if (!valid_number(number))
+                return false;
+            _handler.number(number);
+            token.clear();
+            complete();
+            return true;
+        }
+        // It starts the value beginning with ch, it returns false if no value can start with it
+        bool begin_value(char ch)
+        {
+            switch (ch)
+            {
+            case '{':
+                _handler.begin_object();
+                stack.push_back('{');
+                state = State::ObjectFirst;
+                return true;
+            case '[':
+                _handler.begin_array();
+                stack.push_back('[');
+                state = State::ArrayFirst;
+                return true;
+            case '"':
+                is_key = false;
+                state = State::String;
+                return true;
+            case 't':
+                literal = "true";
+                break;
+            case 'f':
+                literal = "false";
+                break;
+            case 'n':
+                literal = "null";
+                break;
+            default:
+                return false;
+            }
+            matched = 1;
+            state = State::Literal;
+            return true;
+        }
+
+    public:
+        template <typename... Args>
+        explicit JsonReader(Args &&...args) : _handler(std::forward<Args>(args)...) {}
+        Handler &handler() { return _handler; }
+        /**
+         * It consumes the next chunk of text. It returns false as soon as the text is known to be malformed.
+         */
+        bool feed(std::string_view text)
+        {
+            const char *begin = text.data(), *p = begin, *end = begin + text.size();
+            auto offset = [&](const char *at)
+            { return consumed + (at - begin); };
+            while (p < end)
+            {
+                switch (state)
+                {
+                case State::String:
+                {
+                    const char *start = p;
+                    if (escape_pending)
+                    {
+                        escape_pending = false;
+                        ++p;
+                    }
+                    while (p < end)
+                    {
+                        unsigned char ch = *p;
+                        if (!(char_classes[ch] & StringStop))
+                        {
+                            string_bits |= ch;
+                            ++p;
+                            continue;
+                        }
+                        if (ch == '"')
+                            break;
+                        if (ch != '\\')
+                            return fail(offset(p), ParseError::Kind::InvalidString);
+                        has_escape = true;
+                        if (++p == end)
+                        {
+                            escape_pending = true;
+                            break;
+                        }
+                        ++p; // The escaped character is checked when the string is unescaped
+                    }
+                    if (p == end)
+                    {
+                        token.append(start, p - start);
+                        break;
+                    }
+                    bool ok;
+                    if (token.empty())
+                        ok = end_string(std::string_view(start, p - start));
+                    else
+                    {
+                        token.append(start, p - start);
+                        ok = end_string(token);
+                    }
+                    if (!ok)
+                        return fail(offset(p), ParseError::Kind::InvalidString);
+                    ++p; // Skip closing quote
+                    break;
+                }
+                case State::Number:
+                {
+                    const char *start = p;
+                    while (p < end && has_class(*p, NumberPart))
+                        ++p;
+                    if (p == end)
+                    {
+                        token.append(start, p - start);
+                        break;
+                    }
+                    bool ok;
+                    if (token.empty())
+                        ok = end_number(std::string_view(start, p - start));
+                    else
+                    {
+                        token.append(start, p - start);
+                        ok = end_number(token);
+                    }
+                    if (!ok)
+                        return fail(offset(p), ParseError::Kind::InvalidNumber);
+                    break;
+                }
+                case State::Literal:
+                    for (; p < end && literal[matched] != '\0'; ++p, ++matched)
+                        if (*p != literal[matched])
+                            return fail(offset(p), ParseError::Kind::InvalidLiteral);
+                    if (literal[matched] == '\0')
+                    {
+                        if (literal[0] == 'n')
+                            _handler.null();
+                        else
+                            _handler.boolean(literal[0] == 't');
+                        complete();
+                    }
+                    break;
+                case State::Error:
+                    return false;
+                default:
+                {
+                    while (p < end && is_space(*p))
+                        ++p;
+                    if (p == end)
+                        break;
+                    char ch = *p;
+                    if constexpr (requires { _handler.offset(size_t()); })
+                        _handler.offset(offset(p));
+                    switch (state)
+                    {
+                    case State::Value:
+                        if (has_class(ch, NumberStart))
+                        {
+                            state = State::Number;
+                            continue;
+                        }
+                        if (!begin_value(ch))
+                            return fail(offset(p), ParseError::Kind::UnexpectedCharacter);
+                        break;
+                    case State::ObjectFirst:
+                    case State::ObjectKey:
+                        if (ch == '}' && state == State::ObjectFirst)
+                        {
+                            stack.pop_back();
+                            _handler.end_object();
+                            complete();
+                        }
+                        else if (ch == '"')
+                        {
+                            is_key = true;
+                            state = State::String;
+                        }
+                        else
+                            return fail(offset(p), ParseError::Kind::UnexpectedCharacter);
+                        break;
+                    case State::Colon:
+                        if (ch != ':')
+                            return fail(offset(p), ParseError::Kind::UnexpectedCharacter);
+                        state = State::Value;
+                        break;
+                    case State::ObjectNext:
+                        if (ch == ',')
+                            state = State::ObjectKey;
+                        else if (ch == '}')
+                        {
+                            stack.pop_back();
+                            _handler.end_object();
+                            complete();
+                        }
+                        else
+                            return fail(offset(p), ParseError::Kind::UnexpectedCharacter);
+                        break;
+                    case State::ArrayFirst:
+                        if (ch == ']')
+                        {
+                            stack.pop_back();
+                            _handler.end_array();
+                            complete();
+                        }
+                        else if (has_class(ch, NumberStart))
+                        {
+                            state = State::Number;
+                            continue;
+                        }
+                        else if (!begin_value(ch))
+                            return fail(offset(p), ParseError::Kind::UnexpectedCharacter);
+                        break;
+                    case State::ArrayNext:
+                        if (ch == ',')
+                            state = State::Value;
+                        else if (ch == ']')
+                        {
+                            stack.pop_back();
+                            _handler.end_array();
+                            complete();
+                        }
+                        else
+                            return fail(offset(p), ParseError::Kind::UnexpectedCharacter);
+                        break;
+                    default: // State::Done
+                        return fail(offset(p), ParseError::Kind::TrailingCharacters);
+                    }
+                    ++p;
+                }
+                }
+            }
+            consumed += text.size();
+            return true;
+        }
+        /**
+         * It signals the end of the text. It returns true if the text was exactly one well-formed JSON value.
+         */
+        bool finish()
+        {
+            if (state == State::Number && !end_number(token))
+                return fail(consumed, ParseError::Kind::InvalidNumber);
+            if (state == State::Done)
+                return true;
+            if (state != State::Error)
+                fail(consumed, ParseError::Kind::UnexpectedEnd);
+            return false;
+        }
+        bool failed() const { return state == State::Error; }
+        /**
+         * The offset of the first byte that made the text malformed, if failed.
+         */
+        size_t error_offset() const { return _error_offset; }
+        ParseError::Kind error_kind() const { return _error_kind; }
+    };
+
+    class NullHandler
+    {
+        /**
+         * The NullHandler class ignores all the events, so that JsonReader<NullHandler> only checks the grammar.
+         */
+    public:
+        void null() {}
+        void boolean(bool) {}
+        void number(std::string_view) {}
+        void string(std::string_view) {}
+        void key(std::string_view) {}
+        void begin_object() {}
+        void end_object() {}
+        void begin_array() {}
+        void end_array() {}
+    };
+
+    /**
+     * JsonValidator checks text fed in chunks without building anything, e.g. for bodies that arrive in pieces.
+     */
+    using JsonValidator = JsonReader<NullHandler>;
+
+    class Deduplicator
+    {
+        /**
+         * The Deduplicator class hash-conses a document: equal values and subtrees end up sharing one frozen node.
+         * Containers are looked up by their shape, the addresses of their children, which must be shared first,
+         * and the text they retained with ParseOptions::retain_raw.
+         */
+    private:
+        struct StringHash
+        {
+            using is_transparent = void;
+            size_t operator()(std::string_view str) const { return std::hash<std::string_view>()(str); }
+        };
+        std::unordered_map<std::string, Proxy<Node>, StringHash, std::equal_to<>> nodes;
+        std::string signature;
+
+        void append(const void *address) { signature.append(reinterpret_cast<const char *>(&address), sizeof(address)); }
+        // The signature of a node: a tag, then the text of a value or the shape and children of a container
+        void sign(const Node &node)
+        {
+            signature.clear();
+            if (node.key_indexable())
+            {
+                auto &object = static_cast<const ObjectNode &>(node);
+                signature.push_back('o');
+                append(object.shape().get());
+                for (const auto &[key, child] : object)
+                    append(&*child);
+            }
+            else if (node.indexable())
+            {
+                signature.push_back('a');
+                for (auto &child : static_cast<const ArrayNode &>(node))
+                    append(&*child);
+            }
+            else if (node.is_leaf() && !static_cast<const ValueNode &>(node).is_null())
+            {
+                auto &value = static_cast<const ValueNode &>(node);
+                ValueNode::Buffer buffer;
+                signature.push_back(value.kind() == ValueNode::Kind::String ? 's' : value.kind() == ValueNode::Kind::Number ? 'd' : 'b');
+                signature.append(value.text(buffer));
+            }
+            else
+                signature.push_back('n');
+            if (!node.raw().empty())
+            {
+                // Equal containers written differently keep their own text
+                signature.push_back('r');
+                signature.append(node.raw());
+            }
+        }
+        Proxy<Node> find_or_add(const Proxy<Node> &cell)
+        {
+            auto it = nodes.find(signature);
+            if (it != nodes.end())
+                return it->second;
+            cell->freeze();
+            nodes.emplace(signature, cell);
+            return cell;
+        }
+
+    public:
+        /**
+         * It returns the shared value for tag ('s', 'd', 'b' or 'n' for null) and text, made by make on first use.
+         * Values share their cell too: Json hands out the cells of frozen nodes as cells of their own, see Json::found.
+         */
+        template <typename Make>
+        Proxy<Node> value(char tag, std::string_view text, Make make)
+        {
+            signature.assign(1, tag).append(text);
+            auto it = nodes.find(signature);
+            if (it != nodes.end())
+                return it->second;
+            Proxy<Node> cell = make();
+            cell->freeze();
+            nodes.emplace(signature, cell);
+            return cell;
+        }
+        /**
+         * It makes cell reference the shared node equal to its own, which becomes the shared one if there is none.
+         */
+        void share(const Proxy<Node> &cell)
+        {
+            sign(*cell);
+            Proxy<Node> shared = find_or_add(cell);
+            if (&*shared != &*cell)
+            {
+                Proxy<Node> target = cell;
+                target.reset(shared);
+            }
+        }
+        /**
+         * It shares the nodes of a whole subtree, children first. Frozen subtrees are shared as they are.
+         */
+        void share_all(const Proxy<Node> &root)
+        {
+            struct Frame
+            {
+                Proxy<Node> cell;
+                bool expanded;
+            };
+            std::vector<Frame> stack{{root, false}};
+            while (!stack.empty())
+            {
+                Frame frame = stack.back();
+                stack.pop_back();
+                if (frame.expanded || frame.cell->frozen() || frame.cell->is_leaf())
+                {
+                    share(frame.cell);
+                    continue;
+                }
+                stack.push_back({frame.cell, true});
+                if (frame.cell->key_indexable())
+                    for (const auto &[key, child] : *frame.cell.as<ObjectNode>())
+                        stack.push_back({child, false});
+                else if (frame.cell->indexable())
+                    for (auto &child : *frame.cell.as<ArrayNode>())
+                        stack.push_back({child, false});
+            }
+        }
+    };
+
+    class DomBuilder
+    {
+        /**
+         * The DomBuilder class is the JsonReader handler that builds a tree of nodes.
+         */
+    private:
+        std::vector<Proxy<Node>> stack;
+        std::vector<std::pair<std::string, Proxy<Node>>> members; // of the open objects, each object is built once it is closed
+        std::vector<size_t> member_starts;
+        std::string pending_key;
+        std::optional<Proxy<Node>> root;
+        std::shared_ptr<const std::string> source; // the whole text, when the containers retain their spans
+        bool lazy_numbers = false;
+        std::optional<Deduplicator> deduplicator;
+        std::vector<size_t> starts;
+        size_t position = 0;
+
+        template <typename Container>
+        void close()
+        {
+            if (source)
+            {
+                std::string_view text = std::string_view(*source).substr(starts.back(), position + 1 - starts.back());
+                stack.back().as<Container>()->retain({source, text});
+                starts.pop_back();
+            }
+            if (deduplicator)
+                deduplicator->share(stack.back());
+            stack.pop_back();
+        }
+
+        void add(const Proxy<Node> &node)
+        {
+            if (stack.empty())
+                root.emplace(node);
+            else if (stack.back()->key_indexable())
+                members.emplace_back(std::move(pending_key), node);
+            else
+                stack.back().as<ArrayNode>()->add_child(node);
+        }
+        template <typename Make>
+        void add_value(char tag, std::string_view text, Make make)
+        {
+            add(deduplicator ? deduplicator->value(tag, text, make) : make());
+        }
+
+    public:
+        DomBuilder() = default;
+        /**
+         * With ParseOptions::retain_raw, source must be the whole text fed to the reader.
+         */
+        DomBuilder(ParseOptions options, std::shared_ptr<const std::string> source)
+            : source(options.retain_raw ? std::move(source) : nullptr), lazy_numbers(options.lazy_numbers)
+        {
+            if (options.deduplicate)
+                deduplicator.emplace();
+        }
+        void offset(size_t offset) { position = offset; }
+        void null()
+        {
+            add_value('n', {}, []
+                      { return ValueNode::proxy(); });
+        }
+        void boolean(bool value)
+        {
+            add_value('b', value ? "1" : "0", [value]
+                      { return ValueNode::proxy(value); });
+        }
+        void number(std::string_view number)
+        {
+            if (lazy_numbers)
+            {
+                add_value('d', number, [number]
+                          { return ValueNode::number(number); });
+                return;
+            }
+            Number value = Number::parse(number).value_or(Number());
+            if (!deduplicator)
+            {
+                add(ValueNode::proxy(value));
+                return;
+            }
+            add_value('d', value.to_string(), [&value]
+                      { return ValueNode::proxy(value); });
+        }
+        void string(std::string_view value)
+        {
+            add_value('s', value, [value]
+                      { return ValueNode::proxy(std::string(value)); });
+        }
+        void key(std::string_view key) { pending_key.assign(key); }
+        void begin_object()
+        {
+            Proxy<Node> object = ObjectNode::proxy();
+            add(object);
+            stack.push_back(object);
+            member_starts.push_back(members.size());
+            if (source)
+                starts.push_back(position);
+        }
+        void end_object()
+        {
+            stack.back().as<ObjectNode>()->assign(std::span(members).subspan(member_starts.back()));
+            members.erase(members.begin() + member_starts.back(), members.end());
+            member_starts.pop_back();
+            close<ObjectNode>();
+        }
+        void begin_array()
+        {
+            Proxy<Node> array = ArrayNode::proxy();
+            add(array);
+            stack.push_back(array);
+            if (source)
+                starts.push_back(position);
+        }
+        void end_array() { close<ArrayNode>(); }
+        /**
+         * It returns the root of the parsed document, or a null value if nothing was parsed.
+         */
+        Proxy<Node> result() const { return root ? *root : ValueNode::proxy(); }
+    };
+
+    /**
+     * JsonParser builds a Json from text fed in chunks, e.g. ax::Json json = parser.handler().result() once finish() returned true.
+     */
+    using JsonParser = JsonReader<DomBuilder>;
+
+    class Column
+    {
+        /**
+         * The Column class holds the values of one field across all the rows of a ColumnSet, in an Arrow-like layout:
+         * a validity bitmap and one packed vector for the column type. Null rows keep a zero slot in the vectors.
+         * Strings are dictionary encoded: indices into a dictionary stored as one buffer plus offsets.
+         */
+    public:
+        enum class Type : unsigned char
+        {
+            Null, // no value seen yet
+            Int64,
+            Double, // integers are promoted when a column also holds fractional numbers
+            Bool,
+            String
+        };
+        Type type = Type::Null;
+        size_t size = 0;
+        size_t rejected = 0; // values stored as null because their type does not fit the column (or they are objects or arrays)
+        std::vector<uint64_t> validity;
+        std::vector<int64_t> ints;
+        std::vector<double> doubles;
+        std::vector<uint64_t> bools;
+        std::vector<uint32_t> indices;
+        std::string dictionary;
+        std::vector<uint32_t> dictionary_offsets{0};
+
+        static bool bit(const std::vector<uint64_t> &bits, size_t i) { return bits[i / 64] >> (i % 64) & 1; }
+        bool valid(size_t row) const { return bit(validity, row); }
+        bool boolean(size_t row) const { return bit(bools, row); }
+        std::string_view string(size_t row) const
+        {
+            uint32_t index = indices[row];
+            return std::string_view(dictionary).substr(dictionary_offsets[index], dictionary_offsets[index + 1] - dictionary_offsets[index]);
+        }
+    };
+
+    struct ColumnSet
+    {
+        size_t rows = 0;
+        std::map<std::string, Column, std::less<>> columns;
+    };
+
+    class ColumnBuilder
+    {
+        /**
+         * The ColumnBuilder class shreds records into a ColumnSet, one field value at a time.
+         * The type of a column is set by its first value; later values of another type are stored as null and counted as rejected.
+         */
+    private:
+        struct StringHash
+        {
+            using is_transparent = void;
+            size_t operator()(std::string_view str) const { return std::hash<std::string_view>()(str); }
+        };
+        struct Slot
+        {
+            Column column;
+            std::unordered_map<std::string, uint32_t, StringHash, std::equal_to<>> codes;
+        };
+        std::map<std::string, Slot, std::less<>> slots;
+        size_t rows = 0;
+        bool in_row = false;
+
+        static void push_bit(std::vector<uint64_t> &bits, size_t i, bool value)
+        {
+            if (i % 64 == 0)
+                bits.push_back(0);
+            if (value)
+                bits.back() |= uint64_t(1) << (i % 64);
+        }
+        // It returns the slot of field if it has no value in the current row yet
+        Slot *slot(std::string_view field)
+        {
+            auto it = slots.find(field);
+            if (it == slots.end())
+            {
+                it = slots.emplace(std::string(field), Slot()).first;
+                while (it->second.column.size < rows)
+                    append_null(it->second.column);
+            }
+            return it->second.column.size == rows ? &it->second : nullptr;
+        }
+        static void set_type(Column &column, Column::Type type)
+        {
+            column.type = type;
+            switch (type)
+            {
+            case Column::Type::Int64:
+                column.ints.resize(column.size);
+                break;
+            case Column::Type::Double:
+                column.doubles.resize(column.size);
+                break;
+            case Column::Type::Bool:
+                column.bools.resize((column.size + 63) / 64);
+                break;
+            case Column::Type::String:
+                column.indices.resize(column.size);
+                break;
+            default:
+                break;
+            }
+        }
+        static void append_null(Column &column)
+        {
+            push_bit(column.validity, column.size, false);
+            switch (column.type)
+            {
+            case Column::Type::Int64:
+                column.ints.push_back(0);
+                break;
+            case Column::Type::Double:
+                column.doubles.push_back(0);
+                break;
+            case Column::Type::Bool:
+                push_bit(column.bools, column.size, false);
+                break;
+            case Column::Type::String:
+                column.indices.push_back(0);
+                break;
+            default:
+                break;
+            }
+            ++column.size;
+        }
+        // It prepares column for a value of type, it returns false if the value does not fit
+        static bool accept(Column &column, Column::Type type)
+        {
+            if (column.type == Column::Type::Null)
+                set_type(column, type);
+            else if (column.type == Column::Type::Int64 && type == Column::Type::Double)
+            {
+                column.doubles.assign(column.ints.begin(), column.ints.end());
+                column.ints = {};
+                column.type = Column::Type::Double;
+            }
+            else if (column.type != type && !(column.type == Column::Type::Double && type == Column::Type::Int64))
+            {
+                ++column.rejected;
+                append_null(column);
+                return false;
+            }
+            push_bit(column.validity, column.size, true);
+            return true;
+        }
+
+    public:
+        void begin_row() { in_row = true; }
+        void end_row()
+        {
+            ++rows;
+            for (auto &[field, slot] : slots)
+                if (slot.column.size < rows)
+                    append_null(slot.column);
+            in_row = false;
+        }
+        void null(std::string_view field)
+        {
+            if (Slot *target = slot(field))
+                append_null(target->column);
+        }
+        void reject(std::string_view field)
+        {
+            if (Slot *target = slot(field))
+            {
+                ++target->column.rejected;
+                append_null(target->column);
+            }
+        }
+        void integer(std::string_view field, int64_t value)
+        {
+            Slot *target = slot(field);
+            if (!target || !accept(target->column, Column::Type::Int64))
+                return;
+            Column &column = target->column;
+            if (column.type == Column::Type::Double)
+                column.doubles.push_back(static_cast<double>(value));
+            else
+                column.ints.push_back(value);
+            ++column.size;
+        }
+        void floating(std::string_view field, double value)
+        {
+            Slot *target = slot(field);
+            if (!target || !accept(target->column, Column::Type::Double))
+                return;
+            target->column.doubles.push_back(value);
+            ++target->column.size;
+        }
+        /**
+         * It adds a JSON number given as text, as an integer when it has no fraction nor exponent and fits in 64 bits.
+         * A number out of the range of double, or an integer beyond 64 bits for a column of integers, is rejected.
+         */
+        void number(std::string_view field, std::string_view text)
+        {
+            bool integral = text.find_first_of(".eE") == std::string_view::npos;
+            if (integral)
+            {
+                int64_t value;
+                auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+                if (result.ec == std::errc() && result.ptr == text.data() + text.size())
+                {
+                    integer(field, value);
+                    return;
+                }
+            }
+            double value = 0;
+            auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+            auto it = slots.find(field);
+            if (result.ec != std::errc() || !std::isfinite(value) || (integral && it != slots.end() && it->second.column.type == Column::Type::Int64))
+                reject(field);
+            else
+                floating(field, value);
+        }
+        void boolean(std::string_view field, bool value)
+        {
+            Slot *target = slot(field);
+            if (!target || !accept(target->column, Column::Type::Bool))
+                return;
+            push_bit(target->column.bools, target->column.size, value);
+            ++target->column.size;
+        }
+        void string(std::string_view field, std::string_view value)
+        {
+            Slot *target = slot(field);
+            if (!target || !accept(target->column, Column::Type::String))
+                return;
+            Column &column = target->column;
+            auto it = target->codes.find(value);
+            if (it == target->codes.end())
+            {
+                it = target->codes.emplace(std::string(value), static_cast<uint32_t>(column.dictionary_offsets.size() - 1)).first;
+                column.dictionary.append(value);
+                column.dictionary_offsets.push_back(static_cast<uint32_t>(column.dictionary.size()));
+            }
+            column.indices.push_back(it->second);
+            ++column.size;
+        }
+        ColumnSet result()
+        {
+            ColumnSet set;
+            set.rows = rows;
+            for (auto &[field, slot] : slots)
+                set.columns.emplace(field, std::move(slot.column));
+            slots.clear();
+            rows = 0;
+            return set;
+        }
+        /**
+         * It splits a JSON pointer (RFC 6901) such as "/data/items" into its reference tokens.
+         */
+        static std::vector<std::string> split_path(std::string_view path)
+        {
+            std::vector<std::string> tokens;
+            size_t i = path.empty() || path[0] != '/' ? 0 : 1;
+            if (path.empty())
+                return tokens;
+            while (true)
+            {
+                size_t next = path.find('/', i);
+                std::string_view raw = path.substr(i, next == std::string_view::npos ? std::string_view::npos : next - i);
+                std::string token;
+                for (size_t j = 0; j < raw.size(); ++j)
+                {
+                    if (raw[j] == '~' && j + 1 < raw.size() && (raw[j + 1] == '0' || raw[j + 1] == '1'))
+                        token += raw[++j] == '0' ? '~' : '/';
+                    else
+                        token += raw[j];
+                }
+                tokens.push_back(std::move(token));
+                if (next == std::string_view::npos)
+                    return tokens;
+                i = next + 1;
+            }
+        }
+    };
+
+    class ColumnHandler
+    {
+        /**
+         * The ColumnHandler class is a JsonReader handler that shreds the array of records at a JSON pointer into a ColumnSet
+         * while the text is parsed, without building nodes. Only the direct fields of each record are kept, as in Json::to_columns.
+         */
+    private:
+        struct Frame
+        {
+            bool is_array;
+            size_t index = 0; // number of elements started, for arrays
+            std::string key;  // current key, for objects
+        };
+        std::vector<std::string> path;
+        std::vector<Frame> stack;
+        ColumnBuilder builder;
+        size_t target = 0;  // depth of the target array plus one, 0 until it is found
+        size_t skipped = 0; // depth of the nested container being skipped inside a record, 0 if none
+        bool found = false;
+
+        bool in_record() const { return target && stack.size() == target + 1 && !stack.back().is_array; }
+        // It is called at the start of every value, it returns true if the value is a direct field of a record
+        bool start_value()
+        {
+            if (!stack.empty() && stack.back().is_array)
+                ++stack.back().index;
+            return skipped == 0 && in_record();
+        }
+        bool at_path() const
+        {
+            if (found || stack.size() != path.size())
+                return false;
+            for (size_t i = 0; i < path.size(); ++i)
+                if (stack[i].is_array ? std::to_string(stack[i].index - 1) != path[i] : stack[i].key != path[i])
+                    return false;
+            return true;
+        }
+        void begin_container(bool is_array)
+        {
+            bool field = start_value();
+            if (field)
+                builder.reject(stack.back().key);
+            if (skipped || field)
+                ++skipped;
+            else if (is_array && at_path())
+            {
+                target = stack.size() + 1;
+                found = true;
+            }
+            else if (!is_array && target && stack.size() == target)
+                builder.begin_row();
+            else if (target && stack.size() == target)
+            {
+                builder.begin_row(); // A record that is not an object: its row is all null
+                builder.end_row();
+                ++skipped;
+            }
+            stack.push_back({is_array, 0, {}});
+        }
+        void end_container()
+        {
+            stack.pop_back();
+            if (skipped)
+                --skipped;
+            else if (target && stack.size() == target)
+                builder.end_row();
+            else if (target && stack.size() + 1 == target)
+                target = 0;
+        }
+        void scalar_record()
+        {
+            if (target && skipped == 0 && stack.size() == target)
+            {
+                builder.begin_row();
+                builder.end_row();
+            }
+        }
+
+    public:
+        explicit ColumnHandler(std::string_view path) : path(ColumnBuilder::split_path(path)) {}
+        void null()
+        {
+            if (start_value())
+                builder.null(stack.back().key);
+            else
+                scalar_record();
+        }
+        void boolean(bool value)
+        {
+            if (start_value())
+                builder.boolean(stack.back().key, value);
+            else
+                scalar_record();
+        }
+        void number(std::string_view text)
+        {
+            if (start_value())
+                builder.number(stack.back().key, text);
+            else
+                scalar_record();
+        }
+        void string(std::string_view value)
+        {
+            if (start_value())
+                builder.string(stack.back().key, value);
+            else
+                scalar_record();
+        }
+        void key(std::string_view key) { stack.back().key.assign(key); }
+        void begin_object() { begin_container(false); }
+        void end_object() { end_container(); }
+        void begin_array() { begin_container(true); }
+        void end_array() { end_container(); }
+        ColumnSet result() { return builder.result(); }
+    };
+
+    /**
+     * ColumnParser shreds records while parsing, e.g. ax::ColumnParser parser("/events"); then feed, finish and parser.handler().result().
+     */
+    using ColumnParser = JsonReader<ColumnHandler>;
+
+    template <typename T>
+    struct TaskResult
+    {
+        std::optional<T> value;
+        void return_value(T result) { value.emplace(std::move(result)); }
+        T result() { return std::move(*value); }
+    };
+
+    template <>
+    struct TaskResult<void>
+    {
+        void return_void() {}
+        void result() {}
+    };
+
+    template <typename T = void>
+    class Task
+    {
+        /**
+         * The Task class is a lazily started coroutine producing a T.
+         * Awaiting it starts it, and the awaiting coroutine is resumed when it completes.
+         */
+    public:
+        struct promise_type : TaskResult<T>
+        {
+            std::coroutine_handle<> continuation = std::noop_coroutine();
+            std::exception_ptr error;
+
+            struct FinalAwaiter
+            {
+                bool await_ready() noexcept { return false; }
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept { return handle.promise().continuation; }
+                void await_resume() noexcept {}
+            };
+            Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            FinalAwaiter final_suspend() noexcept { return {}; }
+            void unhandled_exception() { error = std::current_exception(); }
+        };
+
+    private:
+        std::coroutine_handle<promise_type> handle;
+        explicit Task(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+    public:
+        Task(Task &&other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+        Task(const Task &) = delete;
+        Task &operator=(const Task &) = delete;
+        ~Task()
+        {
+            if (handle)
+                handle.destroy();
+        }
+        bool await_ready() const noexcept { return false; }
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+        {
+            handle.promise().continuation = awaiting;
+            return handle;
+        }
+        T await_resume()
+        {
+            if (handle.promise().error)
+                std::rethrow_exception(handle.promise().error);
+            return handle.promise().result();
+        }
+    };
+
+    class Json
+    {
+        friend class JsonWriter;
+
+    public:
+        class Key
+        {
+            /**
+             * The Key class is an object key with an inline cache: it remembers the slot of the key in the last shape it was found in,
+             * so that looking it up again in an object of the same shape is a pointer comparison and an indexed load.
+             * A Key must not be used by several threads at once.
+             */
+        private:
+            std::string _name;
+            mutable std::shared_ptr<const Shape> _shape; // keeps the cached shape alive, so that no other shape can take its address
+            mutable size_t _slot = 0;
+
+        public:
+            explicit Key(std::string name) : _name(std::move(name)) {}
+            const std::string &name() const { return _name; }
+            /**
+             * It returns the value of the key in object, or nullptr if it is missing.
+             */
+            const Proxy<Node> *find(const ObjectNode &object) const
+            {
+                if (_shape && object.shape().get() == _shape.get())
+                    return &object.value(_slot);
+                auto [slot, found] = object.locate(_name);
+                if (!found)
+                    return nullptr;
+                if (object.shape()->shared())
+                {
+                    _shape = object.shape();
+                    _slot = slot;
+                }
+                return &object.value(slot);
+            }
+        };
+
+    private:
+        Proxy<Node> root;      // empty until a default constructed Json is modified, see cell
+        bool borrowed = false; // root is the cell of a frozen node inside a shared node, see found
+        /**
+         * The root of every default constructed Json until it is modified: one frozen empty object, never written to.
+         */
+        static const Proxy<Node> &empty_object()
+        {
+            // Never destroyed, Json objects may outlive static objects
+            static const Proxy<Node> *empty = []
+            {
+                auto *cell = new Proxy<Node>(ObjectNode::proxy());
+                (*cell)->freeze();
+                return cell;
+            }();
+            return *empty;
+        }
+        /**
+         * It returns the cell of the root. The const overload reads the shared empty object of a default constructed Json,
+         * so concurrent readers never write to it, and the other one gives it an empty object of its own on first use.
+         */
+        const Proxy<Node> &cell() const { return root.empty() ? empty_object() : root; }
+        const Proxy<Node> &cell()
+        {
+            if (root.empty())
+                root = ObjectNode::proxy();
+            return root;
+        }
+        /**
+         * It returns the cell to store into a container: the shared empty object only ever gets cells of its own.
+         */
+        Proxy<Node> stored_cell() const { return root.empty() ? empty_object().share() : borrowed ? root.share() : root; }
+        /**
+         * It gives a borrowed root a cell of its own, before the root is replaced.
+         */
+        void own()
+        {
+            if (borrowed)
+            {
+                root = root.share();
+                borrowed = false;
+            }
+        }
+        /**
+         * It returns the cell of the root after replacing a frozen root by a copy of its own, before it is modified.
+         */
+        const Proxy<Node> &writable()
+        {
+            own();
+            if (cell()->frozen())
+                root.reset(std::shared_ptr<Node>(cell()->thaw()));
+            return root;
+        }
+        /**
+         * It gives every frozen node of the document a copy of its own, before its leaves are modified in place.
+         */
+        void thaw_all()
+        {
+            own();
+            std::vector<Proxy<Node>> pending{cell()};
+            while (!pending.empty())
+            {
+                Proxy<Node> node = pending.back();
+                pending.pop_back();
+                if (node->frozen())
+                    node.reset(std::shared_ptr<Node>(node->thaw()));
+                if (node->key_indexable())
+                    for (const auto &[key, child] : *node.as<ObjectNode>())
+                        pending.push_back(child);
+                else if (node->indexable())
+                    for (auto &child : *node.as<ArrayNode>())
+                        pending.push_back(child);
+            }
+        }
+        /**
+         * It returns a Json on a cell found by a const lookup, without allocating. The cell of a frozen node may be inside
+         * a node shared with other places, so the Json borrows it: it gets a cell of its own before it is modified
+         * or inserted, and assigning to it leaves the document unchanged.
+         */
+        static Json found(const Proxy<Node> &cell)
+        {
+            Json json(cell);
+            json.borrowed = cell->frozen();
+            return json;
+        }
+        const Proxy<Node> *find_child(std::string_view key) const
+        {
+            if (cell()->key_indexable())
+                return cell().as<ObjectNode>()->find(key);
+            return nullptr;
+        }
+        const Proxy<Node> *find_child(const Key &key) const
+        {
+            if (cell()->key_indexable())
+                return key.find(*cell().as<ObjectNode>());
+            return nullptr;
+        }
+        const Proxy<Node> *find_child(size_t idx) const
+        {
+            if (cell()->indexable())
+                return cell().as<ArrayNode>()->at(idx);
+            return nullptr;
+        }
+
+        // What a chunk of text tells about the document structure, for both possible quote states at its start
+        struct ChunkIndex
+        {
+            bool odd_quotes = false;
+            int depth[2] = {0, 0};                              // net nesting change, if the chunk starts outside (0) or inside (1) a string
+            std::vector<std::pair<size_t, int>> separators[2]; // commas at the lowest relative depth seen so far
+        };
+        static ChunkIndex index_chunk(std::string_view text, size_t begin, size_t end)
+        {
+            ChunkIndex index;
+            int lowest[2] = {0, 0};
+            for (size_t i = begin; i < end; ++i)
+            {
+                char ch = text[i];
+                switch (ch)
+                {
+                case '\\':
+                    ++i; // Outside strings a backslash is an error anyway, so it can be skipped the same way
+                    continue;
+                case '"':
+                    index.odd_quotes = !index.odd_quotes;
+                    continue;
+                case '[':
+                case '{':
+                case ']':
+                case '}':
+                case ',':
+                    break;
+                default:
+                    continue;
+                }
+                // The character is outside a string in the scenario where the chunk starts inside one iff the quotes so far are odd
+                int scenario = index.odd_quotes ? 1 : 0;
+                int &depth = index.depth[scenario];
+                if (ch == '[' || ch == '{')
+                    ++depth;
+                else if (ch == ']' || ch == '}')
+                    lowest[scenario] = std::min(lowest[scenario], --depth);
+                else if (depth == lowest[scenario])
+                    index.separators[scenario].emplace_back(i, depth);
+            }
+            return index;
+        }
+
+        static constexpr size_t leaf_grain = 256;
+        struct LeafHits
+        {
+            size_t count = 0;
+            const Proxy<Node> *first = nullptr; // the first hit in document order
+        };
+        struct CancelChain
+        {
+            const std::atomic<bool> *flag;
+            const CancelChain *parent;
+            bool cancelled() const
+            {
+                for (const CancelChain *link = this; link; link = link->parent)
+                    if (link->flag->load(std::memory_order_relaxed))
+                        return true;
+                return false;
+            }
+        };
+        // It calls visit on every leaf below cell, splitting large child ranges in halves that run as pool tasks
+        template <typename Visit>
+        static void visit_leaves(const Proxy<Node> &cell, ThreadPool &pool, const Visit &visit, bool stop_at_first, const CancelChain *cancel, LeafHits &hits)
+        {
+            const Node &node = *cell;
+            if (node.indexable())
+            {
+                auto &array = static_cast<const ArrayNode &>(node);
+                visit_children(
+                    0, array.size(), [&](size_t i) -> const Proxy<Node> &
+                    { return *array.at(i); },
+                    pool, visit, stop_at_first, cancel, hits);
+            }
+            else if (node.key_indexable())
+            {
+                auto &object = static_cast<const ObjectNode &>(node);
+                if (object.size() <= leaf_grain)
+                {
+                    for (const auto &[key, child] : object)
+                    {
+                        if (stop_at_first && (hits.count > 0 || (cancel && cancel->cancelled())))
+                            return;
+                        visit_leaves(child, pool, visit, stop_at_first, cancel, hits);
+                    }
+                    return;
+                }
+                std::vector<const Proxy<Node> *> cells;
+                cells.reserve(object.size());
+                for (const auto &[key, child] : object)
+                    cells.push_back(&child);
+                visit_children(
+                    0, cells.size(), [&](size_t i) -> const Proxy<Node> &
+                    { return *cells[i]; },
+                    pool, visit, stop_at_first, cancel, hits);
+            }
+            else if (visit(cell))
+            {
+                if (!hits.first)
+                    hits.first = &cell;
+                ++hits.count;
+            }
+        }
+        template <typename Visit, typename At>
+        static void visit_children(size_t begin, size_t end, const At &at, ThreadPool &pool, const Visit &visit, bool stop_at_first, const CancelChain *cancel, LeafHits &hits)
+        {
+            if (end - begin > leaf_grain)
+            {
+                // The right half is offered to other workers, the left half runs here; once the left half has a hit the right one is cancelled
+                size_t middle = begin + (end - begin) / 2;
+                std::atomic<bool> stop_right{false};
+                CancelChain right_cancel{&stop_right, cancel};
+                LeafHits right;
+                TaskGroup group(pool);
+                group.run([&]
+                          { visit_children(middle, end, at, pool, visit, stop_at_first, &right_cancel, right); });
+                visit_children(begin, middle, at, pool, visit, stop_at_first, cancel, hits);
+                if (stop_at_first && hits.count > 0)
+                    stop_right = true;
+                group.wait();
+                hits.count += right.count;
+                if (!hits.first)
+                    hits.first = right.first;
+                return;
+            }
+            for (size_t i = begin; i < end; ++i)
+            {
+                if (stop_at_first && (hits.count > 0 || (cancel && cancel->cancelled())))
+                    return;
+                visit_leaves(at(i), pool, visit, stop_at_first, cancel, hits);
+            }
+        }
+
+        template <typename It, typename WriteOne>
+        static void dump_slices(JsonWriter &writer, It begin, size_t count, JsonFormat format, unsigned indent, ThreadPool &pool, WriteOne write_one)
+        {
+            struct Slice
+            {
+                std::string text; // set only when the slice was written completely
+                std::atomic<bool> done{false};
+            };
+            size_t slices = std::min(count, pool.size() * 4);
+            std::unique_ptr<Slice[]> results(new Slice[slices]);
+            TaskGroup group(pool);
+            for (size_t i = 0; i < slices; ++i)
+            {
+                size_t length = count / slices + (i < count % slices ? 1 : 0);
+                It end = std::next(begin, length);
+                group.run([=, &result = results[i]]
+                          {
+                              struct Done
+                              {
+                                  std::atomic<bool> &done;
+                                  ~Done() { done.store(true, std::memory_order_release); }
+                              } done{result.done};
+                              std::string slice;
+                              {
+                                  OutputBuffer out = OutputBuffer::to_string(slice, OutputBuffer::default_chunk_size);
+                                  JsonWriter slice_writer(out, format, indent);
+                                  slice_writer.nest(1, i == 0);
+                                  for (It it = begin; it != end; ++it)
+                                      write_one(slice_writer, *it);
+                              }
+                              result.text = std::move(slice); });
+                begin = end;
+            }
+            // Slices are spliced in order as they complete; meanwhile this thread runs pool tasks too, like TaskGroup::wait
+            for (size_t i = 0; i < slices; ++i)
+            {
+                while (!results[i].done.load(std::memory_order_acquire))
+                    if (!pool.run_one())
+                        std::this_thread::yield();
+                writer.splice(results[i].text);
+            }
+            group.wait(); // rethrows the first error of a slice
+        }
+
+        template <typename T>
+        static Proxy<Node> to_node(const T &value)
+        {
+            if constexpr (std::is_same_v<T, Json>)
+                return value.stored_cell();
+            else if constexpr (std::is_same_v<T, Number> || std::is_same_v<T, bool> || (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>))
+                return ValueNode::proxy(value);
+            else if constexpr (std::is_same_v<T, std::nullptr_t> || std::is_same_v<T, std::nullopt_t>)
+                return ValueNode::proxy();
+            else if constexpr (std::is_enum_v<T>)
+                return ValueNode::proxy(static_cast<std::underlying_type_t<T>>(value));
+            else if constexpr (JsonStringLike<T>)
+                return ValueNode::proxy(std::string(std::string_view(value)));
+            else if constexpr (IsOptional<T>::value)
+                return value ? to_node(*value) : ValueNode::proxy();
+            else if constexpr (JsonObjectLike<T>)
+            {
+                Proxy<Node> object = ObjectNode::proxy();
+                std::vector<std::pair<std::string, Proxy<Node>>> members;
+                members.reserve(std::size(value));
+                for (auto &[key, item] : value)
+                    members.emplace_back(std::string(std::string_view(key)), to_node(item));
+                object.as<ObjectNode>()->assign(members);
+                return object;
+            }
+            else if constexpr (JsonTupleLike<T>)
+            {
+                Proxy<Node> array = ArrayNode::proxy();
+                ArrayNode *node = array.as<ArrayNode>();
+                node->reserve(std::tuple_size_v<T>);
+                std::apply([node](const auto &...items)
+                           { (node->add_child(to_node(items)), ...); },
+                           value);
+                return array;
+            }
+            else if constexpr (JsonArrayLike<T>)
+            {
+                Proxy<Node> array = ArrayNode::proxy();
+                ArrayNode *node = array.as<ArrayNode>();
+                if constexpr (requires { value.size(); })
+                    node->reserve(value.size());
+                for (auto &item : value)
+                    node->add_child(to_node(item));
+                return array;
+            }
+            else if constexpr (requires(Json &json) { to_json(json, value); })
+            {
+                Json json;
+                to_json(json, value);
+                return json.cell();
+            }
+            else
+                static_assert(sizeof(T) == 0, "No conversion to Json for this type, declare a to_json function");
+        }
+        template <typename T, size_t... I>
+        static bool read_tuple(const ArrayNode &array, T &out, std::index_sequence<I...>)
+        {
+            auto it = array.begin();
+            return (read(*it++, std::get<I>(out)) && ...);
+        }
+        template <typename T>
+        static bool read(const Proxy<Node> &cell, T &out) noexcept(JsonScalar<T>)
+        {
+            const Node &node = *cell;
+            const ValueNode *leaf = node.is_leaf() ? static_cast<const ValueNode *>(&node) : nullptr;
+            if constexpr (IsOptional<T>::value)
+            {
+                if (node.type() == Node::Type::Null || (leaf && leaf->is_null()))
+                {
+                    out.reset();
+                    return true;
+                }
+                typename T::value_type value{};
+                if (!read(cell, value))
+                    return false;
+                out = std::move(value);
+                return true;
+            }
+            else if constexpr (std::is_same_v<T, Json>)
+            {
+                out = found(cell);
+                return true;
+            }
+            else if constexpr (std::is_same_v<T, Number>)
+            {
+                std::optional<Number> value = leaf ? leaf->to_number() : std::nullopt;
+                if (value)
+                    out = std::move(*value);
+                return value.has_value();
+            }
+            else if constexpr (JsonScalar<T> || std::is_same_v<T, std::string>)
+            {
+                if (!leaf || leaf->is_null())
+                    return false;
+                ValueNode::Buffer buffer;
+                std::string_view text = leaf->text(buffer);
+                if constexpr (std::is_same_v<T, bool>)
+                {
+                    if (leaf->kind() != ValueNode::Kind::Boolean)
+                        return false;
+                    out = text != "0";
+                    return true;
+                }
+                else if constexpr (std::is_same_v<T, std::string_view> || std::is_same_v<T, std::string>)
+                {
+                    if (leaf->kind() != ValueNode::Kind::String)
+                        return false;
+                    out = text;
+                    return true;
+                }
+                else if constexpr (std::is_enum_v<T>)
+                {
+                    std::underlying_type_t<T> value;
+                    if (!read(cell, value))
+                        return false;
+                    out = static_cast<T>(value);
+                    return true;
+                }
+                else if constexpr (std::is_integral_v<T>)
+                {
+                    if (leaf->kind() != ValueNode::Kind::Number)
+                        return false;
+                    T value;
+                    const char *end = text.data() + text.size();
+                    auto result = std::from_chars(text.data(), end, value);
+                    if (result.ec == std::errc() && result.ptr == end)
+                    {
+                        out = value;
+                        return true;
+                    }
+                    if (result.ec == std::errc::result_out_of_range || text.find_first_of(".eE") == std::string_view::npos)
+                        return false;
+                    // A fraction or an exponent, such as 1e3 or 2.0: it converts if the value is an integer in range
+                    double real;
+                    if (std::from_chars(text.data(), end, real).ec != std::errc() || real != std::trunc(real) ||
+                        real < static_cast<double>(std::numeric_limits<T>::min()) || real >= std::ldexp(1.0, std::numeric_limits<T>::digits))
+                        return false;
+                    out = static_cast<T>(real);
+                    return true;
+                }
+                else
+                {
+                    if (leaf->kind() != ValueNode::Kind::Number)
+                        return false;
+                    T value;
+                    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+                    if (result.ec != std::errc())
+                        return false;
+                    out = value;
+                    return true;
+                }
+            }
+            else if constexpr (JsonObjectLike<T>)
+            {
+                if (!node.key_indexable())
+                    return false;
+                T result;
+                for (const auto &[key, child] : static_cast<const ObjectNode &>(node))
+                {
+                    typename T::mapped_type value{};
+                    if (!read(child, value))
+                        return false;
+                    result.emplace(key, std::move(value));
+                }
+                out = std::move(result);
+                return true;
+            }
+            else if constexpr (JsonTupleLike<T>)
+            {
+                if (!node.indexable() || static_cast<const ArrayNode &>(node).size() != std::tuple_size_v<T>)
+                    return false;
+                T result{};
+                if (!read_tuple(static_cast<const ArrayNode &>(node), result, std::make_index_sequence<std::tuple_size_v<T>>()))
+                    return false;
+                out = std::move(result);
+                return true;
+            }
+            else if constexpr (JsonArrayLike<T> && requires(T &result, typename T::value_type value) { result.push_back(std::move(value)); })
+            {
+                if (!node.indexable())
+                    return false;
+                const ArrayNode &array = static_cast<const ArrayNode &>(node);
+                T result;
+                if constexpr (requires { result.reserve(array.size()); })
+                    result.reserve(array.size());
+                for (auto &child : array)
+                {
+                    typename T::value_type value{};
+                    if (!read(child, value))
+                        return false;
+                    result.push_back(std::move(value));
+                }
+                out = std::move(result);
+                return true;
+            }
+            else if constexpr (requires(const Json &json) { from_json(json, out); })
+            {
+                Json json = found(cell);
+                if constexpr (std::is_same_v<decltype(from_json(json, out)), bool>)
+                    return from_json(json, out);
+                else
+                {
+                    from_json(json, out);
+                    return true;
+                }
+            }
+            else
+            {
+                static_assert(sizeof(T) == 0, "No conversion from Json to this type, declare a from_json function");
+                return false;
+            }
+        }
+
+    public:
+        /**
+         * An empty object. It allocates nothing until it is modified or copied from a non-const Json.
+         */
+        Json() : root(nullptr) {}
+        /**
+         * A copy references the same node as other, and so does a child inserted or assigned from it: a default constructed
+         * other gets its empty object first. Only a const default constructed Json is not given one, it stays readable
+         * from several threads and its copies are empty objects of their own.
+         */
+        Json(Json &other) : root(other.cell()), borrowed(other.borrowed) {}
+        Json(const Json &other) : root(other.root), borrowed(other.borrowed) {}
+        Json(Proxy<Node> root) : root(root) {}
+        template <ConvertibleToStdString T>
+        Json(T value) : root(ValueNode::proxy(value)) {}
+        Json(const Number &value) : root(ValueNode::proxy(value)) {}
+        template <ConvertibleToStdString T>
+        Json(const std::vector<T> &value) : root(to_node(value)) {}
+        Json(std::initializer_list<std::pair<std::string, Json>> list) : root(ObjectNode::proxy())
+        {
+            std::vector<std::pair<std::string, Proxy<Node>>> members;
+            members.reserve(list.size());
+            for (auto &pair : list)
+                members.emplace_back(pair.first, pair.second.cell().share());
+            root.as<ObjectNode>()->assign(members);
+        }
+        Json(std::string value) : root(ValueNode::proxy(value)) {}
+        Json(const char *value) : root(ValueNode::proxy(value)) {}
+        Json(bool value) : root(ValueNode::proxy(value)) {}
+        Json clone() const
+        {
+            return Json(cell().clone());
+        }
+        static Json array(std::initializer_list<Json> list)
+        {
+            Proxy<Node> array = ArrayNode::proxy();
+            array.as<ArrayNode>()->reserve(list.size());
+            for (auto &elem : list)
+                array.as<ArrayNode>()->add_child(elem.stored_cell());
+            return Json(array);
+        }
+        static Json array(const std::vector<Json> &list)
+        {
+            Proxy<Node> array = ArrayNode::proxy();
+            array.as<ArrayNode>()->reserve(list.size());
+            for (auto &elem : list)
+                array.as<ArrayNode>()->add_child(elem.stored_cell());
+            return Json(array);
+        }
+        Json operator[](std::string key)
+        {
+            writable()->discard_raw();
+            if (cell()->key_indexable())
+                return cell().as<ObjectNode>()->operator[](key);
+            return Json();
+        }
+        /**
+         * Same as operator[] with a string, through the inline cache of key.
+         */
+        Json operator[](const Key &key)
+        {
+            writable()->discard_raw();
+            if (!cell()->key_indexable())
+                return Json();
+            ObjectNode *object = cell().as<ObjectNode>();
+            if (const Proxy<Node> *child = key.find(*object))
+                return Json(*child);
+            return object->operator[](key.name());
+        }
+        Json operator[](size_t idx)
+        {
+            writable()->discard_raw();
+            if (cell()->indexable())
+                return cell().as<ArrayNode>()->operator[](idx);
+            return Json();
+        }
+        /**
+         * It returns a non-owning pointer to the node stored under key, or nullptr if this is not an object or the key is missing.
+         * Unlike operator[], it never inserts into the object nor allocates.
+         */
+        const Node *get_ptr(std::string_view key) const
+        {
+            const Proxy<Node> *child = find_child(key);
+            return child ? child->operator->() : nullptr;
+        }
+        /**
+         * It returns a non-owning pointer to the element at idx, or nullptr if this is not an array or idx is out of range.
+         */
+        const Node *get_ptr(size_t idx) const
+        {
+            const Proxy<Node> *child = find_child(idx);
+            return child ? child->operator->() : nullptr;
+        }
+        bool contains(std::string_view key) const { return find_child(key) != nullptr; }
+        bool contains(const Key &key) const { return find_child(key) != nullptr; }
+        /**
+         * It returns a Json referencing the node stored under key, or an empty optional if there is none.
+         * The returned Json shares the node with this document, no node is created.
+         */
+        std::optional<Json> find(std::string_view key) const
+        {
+            const Proxy<Node> *child = find_child(key);
+            if (child)
+                return found(*child);
+            return std::nullopt;
+        }
+        std::optional<Json> find(const Key &key) const
+        {
+            const Proxy<Node> *child = find_child(key);
+            if (child)
+                return found(*child);
+            return std::nullopt;
+        }
+        std::optional<Json> find(size_t idx) const
+        {
+            const Proxy<Node> *child = find_child(idx);
+            if (child)
+                return found(*child);
+            return std::nullopt;
+        }
+        /**
+         * Same as find, but it throws std::out_of_range if there is no such node.
+         */
+        Json at(std::string_view key) const
+        {
+            const Proxy<Node> *child = find_child(key);
+            if (!child)
+                AX_JSON_THROW(std::out_of_range("Key not found"));
+            return found(*child);
+        }
+        Json at(const Key &key) const
+        {
+            const Proxy<Node> *child = find_child(key);
+            if (!child)
+                AX_JSON_THROW(std::out_of_range("Key not found"));
+            return found(*child);
+        }
+        Json at(size_t idx) const
+        {
+            const Proxy<Node> *child = find_child(idx);
+            if (!child)
+                AX_JSON_THROW(std::out_of_range("Index out of range"));
+            return found(*child);
+        }
+        /**
+         * It shreds the array of records at path (a JSON pointer, "" for the root) into one typed column per field.
+         * Only the direct fields of each record are kept, nested objects and arrays are stored as null and counted as rejected.
+         * If there is no array at path, the result has no rows. See ColumnParser to do the same while parsing.
+         */
+        ColumnSet to_columns(std::string_view path = "") const
+        {
+            const Proxy<Node> *target = &cell();
+            for (auto &token : ColumnBuilder::split_path(path))
+            {
+                if ((*target)->key_indexable())
+                    target = target->as<ObjectNode>()->find(token);
+                else if ((*target)->indexable())
+                {
+                    size_t idx = 0;
+                    auto result = std::from_chars(token.data(), token.data() + token.size(), idx);
+                    target = result.ec == std::errc() && result.ptr == token.data() + token.size() ? target->as<ArrayNode>()->at(idx) : nullptr;
+                }
+                else
+                    target = nullptr;
+                if (!target)
+                    return {};
+            }
+            if (!(*target)->indexable())
+                return {};
+            ColumnBuilder builder;
+            for (auto &record : *target->as<ArrayNode>())
+            {
+                builder.begin_row();
+                if (record->key_indexable())
+                    for (const auto &[field, child] : *record.as<ObjectNode>())
+                    {
+                        if (!child->is_leaf())
+                        {
+                            builder.reject(field);
+                            continue;
+                        }
+                        const ValueNode *value = child.as<ValueNode>();
+                        ValueNode::Buffer buffer;
+                        if (value->is_null())
+                            builder.null(field);
+                        else if (value->kind() == ValueNode::Kind::Number)
+                            builder.number(field, value->text(buffer));
+                        else if (value->kind() == ValueNode::Kind::Boolean)
+                            builder.boolean(field, value->text() != "0");
+                        else
+                            builder.string(field, value->text());
+                    }
+                builder.end_row();
+            }
+            return builder.result();
+        }
+        /**
+         * The following algorithms walk all the leaves (values that are neither objects nor arrays) of the document on the pool threads,
+         * splitting large arrays and objects into ranges that idle workers steal. The callbacks must be safe to call concurrently,
+         * and the structure of the document must not change while they run.
+         */
+        template <typename F>
+        void for_each_leaf(F f, ThreadPool &pool = ThreadPool::shared()) const
+        {
+            LeafHits hits;
+            visit_leaves(
+                cell(), pool, [&](const Proxy<Node> &leaf)
+                {
+                    f(found(leaf));
+                    return false; },
+                false, nullptr, hits);
+        }
+        /**
+         * It discards the original text retained by the containers of this subtree (see ParseOptions::retain_raw).
+         * Frozen subtrees keep theirs, they are copied before any modification anyway.
+         */
+        void discard_raw()
+        {
+            std::vector<Node *> pending{&*cell()};
+            while (!pending.empty())
+            {
+                Node *node = pending.back();
+                pending.pop_back();
+                if (node->frozen())
+                    continue;
+                node->discard_raw();
+                if (node->key_indexable())
+                    for (const auto &[key, child] : *static_cast<ObjectNode *>(node))
+                        pending.push_back(&*child);
+                else if (node->indexable())
+                    for (auto &child : *static_cast<ArrayNode *>(node))
+                        pending.push_back(&*child);
+            }
+        }
+        /**
+         * It makes equal values and subtrees of the document share one frozen node, like parsing with ParseOptions::deduplicate.
+         * operator[] and transform copy frozen nodes on write, one level at a time, so the document behaves as if nothing were shared.
+         * Json handles taken into the document before must not be used to modify it.
+         */
+        void deduplicate() { Deduplicator().share_all(cell()); }
+        /**
+         * It moves every node of the document, with its control block, strings and child vectors, into one new arena,
+         * in depth-first order, and releases the scattered nodes left behind by modifications. The cells stay where they are:
+         * nodes keep their cells, so Json handles into the document stay valid, and shared nodes stay shared.
+         * The arena is released once its last node is. Containers that grow afterwards allocate from the arena, which never
+         * reuses memory, until the next compact: call it again after many modifications.
+         */
+        void compact()
+        {
+            static constexpr size_t control_block_size = 64; // an estimate, for the size of the arena
+            struct Entry
+            {
+                Proxy<Node> cell;
+                size_t node;
+            };
+            struct Release
+            {
+                void operator()(Node *node) const { Node::destroy(node); }
+            };
+            std::vector<Entry> cells;
+            std::vector<const Node *> nodes;
+            std::unordered_map<const Node *, size_t> index;
+            size_t bytes = 0;
+            std::vector<Proxy<Node>> pending{cell()};
+            while (!pending.empty())
+            {
+                Proxy<Node> current = pending.back();
+                pending.pop_back();
+                auto [it, inserted] = index.emplace(&*current, nodes.size());
+                cells.push_back({current, it->second});
+                if (!inserted)
+                    continue;
+                nodes.push_back(&*current);
+                // Children are pushed last first, so that they are placed in document order
+                if (current->key_indexable())
+                {
+                    const ObjectNode *object = current.as<ObjectNode>();
+                    bytes += sizeof(ObjectNode) + object->size() * sizeof(Proxy<Node>);
+                    for (size_t slot = object->size(); slot-- > 0;)
+                        pending.push_back(object->value(slot));
+                }
+                else if (current->indexable())
+                {
+                    const ArrayNode *array = current.as<ArrayNode>();
+                    bytes += sizeof(ArrayNode) + array->size() * sizeof(Proxy<Node>);
+                    for (size_t idx = array->size(); idx-- > 0;)
+                        pending.push_back(*array->at(idx));
+                }
+                else
+                    bytes += sizeof(ValueNode) + (current->is_leaf() ? current.as<ValueNode>()->text().size() + 1 : 0);
+            }
+            bytes += nodes.size() * control_block_size;
+            auto arena = std::make_shared<Arena>(bytes + bytes / 8);
+            std::vector<std::shared_ptr<Node>> relocated;
+            relocated.reserve(nodes.size());
+            for (const Node *node : nodes)
+                relocated.emplace_back(node->relocate(*arena), Release(), Arena::Allocator<Node>(arena));
+            for (auto &entry : cells)
+                entry.cell.reset(relocated[entry.node]);
+            NodePool::trim(); // the blocks of the old nodes
+        }
+        /**
+         * It replaces every leaf with f(leaf).
+         */
+        template <typename F>
+        void transform(F f, ThreadPool &pool = ThreadPool::shared())
+        {
+            thaw_all();
+            discard_raw();
+            LeafHits hits;
+            visit_leaves(
+                cell(), pool, [&](const Proxy<Node> &leaf)
+                {
+                    Json target(leaf);
+                    target = f(target);
+                    return false; },
+                false, nullptr, hits);
+        }
+        template <typename Predicate>
+        size_t count_if(Predicate predicate, ThreadPool &pool = ThreadPool::shared()) const
+        {
+            LeafHits hits;
+            visit_leaves(
+                cell(), pool, [&](const Proxy<Node> &leaf)
+                { return static_cast<bool>(predicate(found(leaf))); },
+                false, nullptr, hits);
+            return hits.count;
+        }
+        /**
+         * It returns the first leaf in document order for which predicate holds. The ranges after a hit are cancelled.
+         */
+        template <typename Predicate>
+        std::optional<Json> find_first(Predicate predicate, ThreadPool &pool = ThreadPool::shared()) const
+        {
+            LeafHits hits;
+            visit_leaves(
+                cell(), pool, [&](const Proxy<Node> &leaf)
+                { return static_cast<bool>(predicate(found(leaf))); },
+                true, nullptr, hits);
+            if (hits.first)
+                return found(*hits.first);
+            return std::nullopt;
+        }
+        Json operator=(Json other)
+        {
+            own();
+            root.reset(other.cell());
+            return *this;
+        }
+        Json operator=(const std::string &value)
+        {
+            own();
+            root.reset(ValueNode::make(value));
+            return *this;
+        }
+        Json operator=(const char *value)
+        {
+            own();
+            root.reset(ValueNode::make(value));
+            return *this;
+        }
+        template <ConvertibleToStdString T>
+        Json operator=(const std::vector<T> &value)
+        {
+            own();
+            root.reset(to_node(value));
+            return *this;
+        }
+        template <ConvertibleToStdString T>
+        Json operator=(T value)
+        {
+            own();
+            root.reset(ValueNode::make(value));
+            return *this;
+        }
+        Json operator=(const Number &value)
+        {
+            own();
+            root.reset(ValueNode::make(value));
+            return *this;
+        }
+        /**
+         * It converts a value leniently, like std::stol and std::stod: a string such as "42" converts to a number,
+         * and int, short and float are narrowed from long and double. Supported types are long, int, short, double, float,
+         * std::string and Number. See get for strict and range checked conversions.
+         */
+        template <typename T>
+        std::optional<T> to() const
+        {
+            static_assert(std::is_same_v<T, long> || std::is_same_v<T, int> || std::is_same_v<T, short> || std::is_same_v<T, double> ||
+                              std::is_same_v<T, float> || std::is_same_v<T, std::string> || std::is_same_v<T, Number>,
+                          "Json::to does not support this type, see Json::get");
+            std::optional<T> result;
+            if (!cell()->is_leaf())
+                return result;
+            const ValueNode *leaf = cell().as<ValueNode>();
+            if constexpr (std::is_same_v<T, std::string>)
+                result = leaf->value();
+            else if constexpr (std::is_same_v<T, Number>)
+                result = leaf->to_number(); // The exact value of a number, without narrowing
+            else if constexpr (std::is_floating_point_v<T>)
+            {
+                std::optional<double> value = leaf->to_double();
+                if (value.has_value())
+                    result = static_cast<T>(*value);
+            }
+            else
+            {
+                std::optional<long> value = leaf->to_long();
+                if (value.has_value())
+                    result = static_cast<T>(*value);
+            }
+            return result;
+        }
+        /**
+         * The builder functions make a container with its final size known at compile time, and convert each item as from does,
+         * without a Json per item, e.g. Json::object_of(member("id", 7), member("tags", Json::array_of("a", "b"))).
+         */
+        template <typename... Items>
+        static Json array_of(const Items &...items)
+        {
+            Proxy<Node> array = ArrayNode::proxy();
+            ArrayNode *node = array.as<ArrayNode>();
+            node->reserve(sizeof...(Items));
+            (node->add_child(to_node(items)), ...);
+            return Json(array);
+        }
+        template <typename... Values>
+        static Json object_of(const Member<Values> &...members)
+        {
+            // Built like a parsed object: one shape lookup and one reserve
+            std::array<std::pair<std::string, Proxy<Node>>, sizeof...(Values)> items{
+                std::pair<std::string, Proxy<Node>>(std::string(members.key), to_node(members.value))...};
+            Proxy<Node> object = ObjectNode::proxy();
+            object.as<ObjectNode>()->assign(items);
+            return Json(object);
+        }
+        /**
+         * It builds a document from a C++ value in one pass: arithmetic types, enums, strings, Number, std::optional (null when empty),
+         * maps with string keys (objects), tuples, pairs and std::array (arrays), any other range (arrays), nested in any way,
+         * and types with a to_json function found by argument dependent lookup.
+         */
+        template <typename T>
+        static Json from(const T &value) { return Json(to_node(value)); }
+        /**
+         * It returns the value as T if the JSON types match, nothing otherwise. Scalars convert without exceptions nor allocation:
+         * any integer type from a number that is an integer in range, float or double from a number in range, bool from a boolean,
+         * std::string_view from a string (a view of the stored text, valid while the node is), and an enum from its underlying integer.
+         * Containers convert as in from, to any range with push_back, and types with a from_json function found by argument dependent lookup.
+         */
+        template <typename T>
+        std::optional<T> get() const noexcept(JsonScalar<T>)
+        {
+            T value{};
+            if (get_if(value))
+                return value;
+            return std::nullopt;
+        }
+        /**
+         * Same as get, but it stores the value into out and returns true when it converts, and leaves out unchanged otherwise.
+         */
+        template <typename T>
+        bool get_if(T &out) const noexcept(JsonScalar<T>) { return read(cell(), out); }
+        template <typename T>
+        std::optional<std::vector<T>> asVector() const
+        {
+            std::optional<std::vector<T>> result;
+            if (cell()->indexable())
+            {
+                const ArrayNode *array = cell().as<ArrayNode>();
+                result = std::vector<T>();
+                result->reserve(array->size());
+                for (auto &child : *array)
+                {
+                    std::optional<T> value = Json(child).to<T>();
+                    if (value.has_value())
+                    {
                         result.value().push_back(value.value());
                     }
                 }
@@ -506,39 +5108,406 @@ namespace ax
         }
         static Json parse_str(std::string const &str)
         {
-            std::ostringstream oss;
-
-            // Remove whitespace, but not inside strings
-            bool inside = false;
-            for (char ch : str)
+            JsonParser parser;
+            if (!parser.feed(str) || !parser.finish())
+                AX_JSON_THROW(MalformedJson(ParseError::locate(str, parser.error_kind(), parser.error_offset())));
+            return parser.handler().result();
+        }
+        static Json parse_str(std::string_view str, ParseOptions options)
+        {
+            auto result = try_parse(str, options);
+            if (!result)
+                AX_JSON_THROW(MalformedJson(result.error()));
+            return *result;
+        }
+        /**
+         * It checks that str is exactly one well-formed JSON value, including the UTF-8 encoding of strings,
+         * with the tokenizer of parse_str but without building nodes. It returns the first error, if any.
+         */
+        static std::optional<ParseError> validate(std::string_view str)
+        {
+            JsonValidator validator;
+            if (!validator.feed(str) || !validator.finish())
+                return ParseError::locate(str, validator.error_kind(), validator.error_offset());
+            return std::nullopt;
+        }
+        static bool is_valid(std::string_view str)
+        {
+            JsonValidator validator;
+            return validator.feed(str) && validator.finish();
+        }
+        /**
+         * Same as parse_str, but it returns the error instead of throwing, so it can be used on untrusted input
+         * and in builds without exceptions.
+         */
+        static Expected<Json, ParseError> try_parse(std::string_view str, ParseOptions options = {})
+        {
+            std::shared_ptr<const std::string> source;
+            if (options.retain_raw)
             {
-                if (ch == '"')
-                    inside = !inside;
-                if (std::isspace(ch) && !inside)
-                    continue;
-                oss << ch;
+                source = std::make_shared<const std::string>(str);
+                str = *source;
             }
+            JsonParser parser(options, source);
+            if (!parser.feed(str) || !parser.finish())
+                return Unexpected<ParseError>(ParseError::locate(str, parser.error_kind(), parser.error_offset()));
+            return Json(parser.handler().result());
+        }
+        /**
+         * It parses a single large document on the pool threads, when its root is an array or an object.
+         * A first pass indexes chunks of the text in parallel, for both possible quote states at the start of each chunk,
+         * and resolves the real states in order to find the separators between the top level elements.
+         * The elements are then parsed in groups on the pool threads, and appended to the root in order.
+         * It runs as TaskGroup fork/join, so it may be called from a pool task. Errors are located in the whole text, like parse_str.
+         * Nodes come from the per-thread free lists of NodePool; call compact on the result to gather them into one arena.
+         */
+        static Json parse_parallel(std::string_view text, ThreadPool &pool = ThreadPool::shared())
+        {
+            static constexpr size_t min_parallel_size = 1 << 20;
+            static constexpr size_t min_chunk_size = 1 << 16;
+            auto parse_sequential = [text]
+            {
+                JsonParser parser;
+                if (!parser.feed(text) || !parser.finish())
+                    AX_JSON_THROW(MalformedJson(ParseError::locate(text, parser.error_kind(), parser.error_offset())));
+                return Json(parser.handler().result());
+            };
+            auto is_space = [](char ch)
+            { return ch == ' ' || ch == '\n' || ch == '\r' || ch == '\t'; };
+            size_t open = 0, close = text.size();
+            while (open < text.size() && is_space(text[open]))
+                ++open;
+            while (close > open && is_space(text[close - 1]))
+                --close;
+            bool is_array = open < close && text[open] == '[' && text[close - 1] == ']';
+            bool is_object = open < close && text[open] == '{' && text[close - 1] == '}';
+            if (text.size() < min_parallel_size || !(is_array || is_object) || close - open < 2)
+                return parse_sequential();
+            --close; // Position of the closing bracket
 
-            std::string str_clean = oss.str();
+            // Phase one: speculative structural index of every chunk. Chunks never start right after a backslash,
+            // so whether their first character is escaped never depends on the previous chunk. The first chunk starts
+            // inside the root, so that its top level separators are at its lowest depth like in the other chunks.
+            size_t chunk_size = std::max(min_chunk_size, text.size() / (pool.size() * 4));
+            std::vector<size_t> bounds{open + 1};
+            while (bounds.back() < text.size())
+            {
+                size_t bound = std::min(text.size(), bounds.back() + chunk_size);
+                while (bound < text.size() && text[bound - 1] == '\\')
+                    ++bound;
+                bounds.push_back(bound);
+            }
+            std::vector<ChunkIndex> indexes(bounds.size() - 1);
+            {
+                TaskGroup group(pool);
+                for (size_t i = 0; i < indexes.size(); ++i)
+                    group.run([&, i]
+                              { indexes[i] = index_chunk(text, bounds[i], bounds[i + 1]); });
+                group.wait();
+            }
+            std::vector<size_t> separators;
+            bool in_string = false;
+            int depth = 1;
+            for (auto &index : indexes)
+            {
+                int scenario = in_string ? 1 : 0;
+                for (auto &[position, relative] : index.separators[scenario])
+                    if (depth + relative == 1)
+                        separators.push_back(position);
+                depth += index.depth[scenario];
+                in_string ^= index.odd_quotes;
+            }
+            if (in_string || depth != 0)
+                return parse_sequential(); // to locate the error
 
-            size_t index = 0;
-            return parse_recursively(str_clean, index);
+            // Phase two: parse groups of consecutive elements, each one wrapped in its own container, and stitch them
+            std::vector<size_t> starts{open + 1}, ends;
+            for (size_t separator : separators)
+            {
+                ends.push_back(separator);
+                starts.push_back(separator + 1);
+            }
+            ends.push_back(close);
+            Proxy<Node> result = is_array ? ArrayNode::proxy() : ObjectNode::proxy();
+            if (separators.empty() && std::all_of(text.begin() + open + 1, text.begin() + close, is_space))
+                return result;
+            struct Part
+            {
+                size_t begin, end;
+                Proxy<Node> node = nullptr;
+                std::optional<ParseError> error; // with its offset in the whole text
+            };
+            size_t groups = std::min(starts.size(), pool.size() * 4);
+            size_t group_size = (close - open) / groups + 1;
+            std::vector<Part> parts;
+            for (size_t first = 0; first < starts.size();)
+            {
+                size_t last = first;
+                while (last + 1 < starts.size() && ends[last] - starts[first] < group_size)
+                    ++last;
+                parts.push_back({starts[first], ends[last], nullptr, std::nullopt});
+                first = last + 1;
+            }
+            {
+                TaskGroup group(pool);
+                for (Part &part : parts)
+                    group.run([&part, text, is_array]
+                              {
+                                  JsonParser parser;
+                                  if (parser.feed(is_array ? "[" : "{") && parser.feed(text.substr(part.begin, part.end - part.begin)) &&
+                                      parser.feed(is_array ? "]" : "}") && parser.finish())
+                                      part.node = parser.handler().result();
+                                  else
+                                  {
+                                      // Offsets in the part count the opening bracket that wraps it
+                                      size_t offset = part.begin + std::min(parser.error_offset() - std::min<size_t>(parser.error_offset(), 1), part.end - part.begin);
+                                      part.error = ParseError{parser.error_kind(), offset};
+                                  } });
+                group.wait(); // every task has finished, even if one threw
+            }
+            std::vector<std::pair<std::string, Proxy<Node>>> members;
+            for (Part &part : parts)
+            {
+                if (part.error)
+                    AX_JSON_THROW(MalformedJson(ParseError::locate(text, part.error->kind, part.error->offset)));
+                if (is_array)
+                    for (auto &child : *part.node.as<ArrayNode>())
+                        result.as<ArrayNode>()->add_child(child);
+                else
+                    for (const auto &[key, child] : *part.node.as<ObjectNode>())
+                        members.emplace_back(key, child);
+            }
+            if (!is_array)
+                result.as<ObjectNode>()->assign(members);
+            return result;
+        }
+        /**
+         * It parses the text produced by source, a coroutine friendly reader: co_await source.read() must yield
+         * the next chunk as something convertible to std::string_view, and an empty chunk at the end of the text.
+         * The parser consumes each chunk as soon as it is available, so only the document is kept in memory.
+         */
+        template <typename Source>
+        static Task<Json> parse_async(Source &source)
+        {
+            JsonParser parser;
+            while (true)
+            {
+                auto chunk = co_await source.read();
+                std::string_view text(chunk);
+                if (text.empty())
+                    break;
+                if (!parser.feed(text))
+                    AX_JSON_THROW(MalformedJson());
+            }
+            if (!parser.finish())
+                AX_JSON_THROW(MalformedJson());
+            co_return Json(parser.handler().result());
         }
         static Json parse_file(std::string const &filename)
         {
             std::ifstream file(filename);
             if (!file.is_open())
-                throw std::runtime_error("File not found");
+                AX_JSON_THROW(std::runtime_error("File not found"));
             std::ostringstream oss;
             oss << file.rdbuf();
             return Json::parse_str(oss.str());
         }
+        /**
+         * It loads and parses filename without blocking the caller, see AsyncFile.
+         */
+        static std::future<Json> parse_file_async(std::string filename, ThreadPool &pool = ThreadPool::shared())
+        {
+#ifdef AX_JSON_HAS_POSIX_IO
+            auto promise = std::make_shared<std::promise<Json>>();
+            auto future = promise->get_future();
+            auto parser = std::make_shared<JsonParser>();
+            AsyncFile::read(
+                std::move(filename), pool, [parser](std::string_view data)
+                { parser->feed(data); },
+                [parser, promise](std::string &&, std::exception_ptr error)
+                {
+                    if (error)
+                        promise->set_exception(error);
+                    else if (!parser->finish())
+                        promise->set_exception(std::make_exception_ptr(MalformedJson()));
+                    else
+                        promise->set_value(parser->handler().result());
+                });
+            return future;
+#else
+            return pool.submit([filename = std::move(filename)]
+                               { return Json::parse_file(filename); });
+#endif
+        }
+        /**
+         * It serializes the document on the pool and saves it to filename without blocking the caller.
+         * The document must not be modified until the returned future is ready.
+         */
+        std::future<void> dump_file_async(std::string filename, JsonFormat format = JsonFormat::Spaced, unsigned indent = 4, ThreadPool &pool = ThreadPool::shared()) const
+        {
+            auto promise = std::make_shared<std::promise<void>>();
+            auto future = promise->get_future();
+            pool.submit([self = *this, filename = std::move(filename), format, indent, promise, &pool]() mutable
+                        {
+                            std::string text = self.dump(format, indent);
+#ifdef AX_JSON_HAS_POSIX_IO
+                            AsyncFile::write(std::move(filename), std::move(text), pool, [promise](std::string &&, std::exception_ptr error)
+                                             {
+                                                 if (error)
+                                                     promise->set_exception(error);
+                                                 else
+                                                     promise->set_value(); });
+#else
+                            std::ofstream file(filename);
+                            file << text;
+                            if (file)
+                                promise->set_value();
+                            else
+                                promise->set_exception(std::make_exception_ptr(std::runtime_error("Write failed")));
+#endif
+                        });
+            return future;
+        }
+        /**
+         * It serializes the document into out, through the same writer used by operator<<.
+         * JsonFormat::Compact drops all optional whitespace, JsonFormat::Pretty puts each member on its own line.
+         */
+        void dump(OutputBuffer &out, JsonFormat format = JsonFormat::Spaced, unsigned indent = 4) const
+        {
+            JsonWriter writer(out, format, indent);
+            cell()->write(writer);
+        }
+        /**
+         * Same as dump, but the elements of a large top level array or object are serialized in slices on the pool threads.
+         * Slices are written to out in order as they complete; slices larger than the chunk size of out reach its sink without a further copy.
+         */
+        void dump_parallel(OutputBuffer &out, JsonFormat format = JsonFormat::Spaced, unsigned indent = 4, ThreadPool &pool = ThreadPool::shared()) const
+        {
+            static constexpr size_t min_parallel_size = 1024;
+            JsonWriter writer(out, format, indent);
+            if (!cell()->raw().empty())
+                cell()->write(writer);
+            else if (cell()->indexable() && cell().as<ArrayNode>()->size() >= min_parallel_size)
+            {
+                const ArrayNode *array = cell().as<ArrayNode>();
+                writer.begin_array();
+                dump_slices(writer, array->begin(), array->size(), format, indent, pool,
+                            [](JsonWriter &slice_writer, const Proxy<Node> &child)
+                            { child->write(slice_writer); });
+                writer.end_array();
+            }
+            else if (cell()->key_indexable() && cell().as<ObjectNode>()->size() >= min_parallel_size)
+            {
+                const ObjectNode *object = cell().as<ObjectNode>();
+                writer.begin_object();
+                dump_slices(writer, object->begin(), object->size(), format, indent, pool,
+                            [](JsonWriter &slice_writer, const auto &member)
+                            {
+                                slice_writer.key(member.first);
+                                member.second->write(slice_writer);
+                            });
+                writer.end_object();
+            }
+            else
+                cell()->write(writer);
+        }
+        /**
+         * It serializes the document into sink, a coroutine friendly writer: co_await sink.write(chunk) must consume a std::string_view.
+         * The output is handed over in chunks of about chunk_size bytes, and the serializer is suspended while the sink is busy.
+         * The document must not be modified until the returned task completes.
+         */
+        template <typename Sink>
+        Task<> dump_async(Sink &sink, JsonFormat format = JsonFormat::Spaced, unsigned indent = 4, size_t chunk_size = OutputBuffer::default_chunk_size) const
+        {
+            struct Frame
+            {
+                const Node *node;
+                ObjectNode::const_iterator member;
+                ArrayNode::const_iterator element;
+            };
+            Proxy<Node> document = cell();
+            std::string pending;
+            OutputBuffer out = OutputBuffer::to_string(pending, chunk_size);
+            JsonWriter writer(out, format, indent);
+            std::vector<Frame> stack;
+            auto visit = [&](const Node &node)
+            {
+                if (!node.raw().empty())
+                    node.write(writer);
+                else if (node.key_indexable())
+                {
+                    auto &object = static_cast<const ObjectNode &>(node);
+                    writer.begin_object();
+                    stack.push_back({&node, object.begin(), {}});
+                }
+                else if (node.indexable())
+                {
+                    auto &array = static_cast<const ArrayNode &>(node);
+                    writer.begin_array();
+                    stack.push_back({&node, {}, array.begin()});
+                }
+                else
+                    node.write(writer);
+            };
+            visit(*document);
+            while (!stack.empty())
+            {
+                Frame &frame = stack.back();
+                if (frame.node->key_indexable())
+                {
+                    if (frame.member == static_cast<const ObjectNode *>(frame.node)->end())
+                    {
+                        writer.end_object();
+                        stack.pop_back();
+                    }
+                    else
+                    {
+                        const auto &[key, child] = *frame.member++;
+                        writer.key(key);
+                        visit(*child);
+                    }
+                }
+                else
+                {
+                    if (frame.element == static_cast<const ArrayNode *>(frame.node)->end())
+                    {
+                        writer.end_array();
+                        stack.pop_back();
+                    }
+                    else
+                        visit(**frame.element++);
+                }
+                if (!pending.empty())
+                {
+                    co_await sink.write(std::string_view(pending));
+                    pending.clear();
+                }
+            }
+            out.flush();
+            if (!pending.empty())
+                co_await sink.write(std::string_view(pending));
+        }
+        std::string dump(JsonFormat format = JsonFormat::Spaced, unsigned indent = 4) const
+        {
+            std::string result;
+            {
+                OutputBuffer out = OutputBuffer::to_string(result);
+                dump(out, format, indent);
+            }
+            return result;
+        }
         friend std::ostream &operator<<(std::ostream &os, const Json &json)
         {
-            os << json.root;
+            os << json.cell();
             return os;
         }
     };
+
+    inline JsonWriter &JsonWriter::value(const Json &json)
+    {
+        json.cell()->write(*this);
+        return *this;
+    }
 }
 
 #endif // AX_JSON_SINGLE_INCLUDE_HPP
\ No newline at end of file
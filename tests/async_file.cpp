@@ -0,0 +1,78 @@
+#include "json.hpp"
+#include "check.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+// Built twice: with io_uring when the kernel supports it, and with AX_JSON_NO_IO_URING for the pread/pwrite tasks
+int main()
+{
+    ax::ThreadPool pool(4);
+    std::filesystem::path path = std::filesystem::temp_directory_path() / ("ax_json_async_file_" + std::to_string(::getpid()) + ".json");
+
+    // A document of several chunks goes through dump_file_async and parse_file_async unchanged
+    std::vector<ax::Json> items;
+    for (int i = 0; i < 100000; ++i)
+        items.push_back(ax::Json::object_of(ax::member("id", i), ax::member("name", "item " + std::to_string(i))));
+    ax::Json doc = ax::Json::array(items);
+    doc.dump_file_async(path.string(), ax::JsonFormat::Spaced, 4, pool).get();
+    CHECK(std::filesystem::file_size(path) > 2 * ax::AsyncFile::chunk_size);
+    CHECK(ax::Json::parse_file(path.string()).dump() == doc.dump());
+    CHECK(ax::Json::parse_file_async(path.string(), pool).get().dump() == doc.dump());
+
+    // Data arrives in order and the done callback gets the whole file
+    std::string pieces;
+    std::promise<std::string> whole;
+    ax::AsyncFile::read(
+        path.string(), pool, [&](std::string_view data)
+        { pieces.append(data); },
+        [&](std::string &&data, std::exception_ptr error)
+        {
+            CHECK(!error);
+            whole.set_value(std::move(data));
+        });
+    std::string data = whole.get_future().get();
+    CHECK(data == doc.dump());
+    CHECK(pieces == data);
+
+    // Errors reach the futures
+    {
+        std::ofstream(path) << "[1, 2";
+    }
+    bool malformed = false;
+    try
+    {
+        ax::Json::parse_file_async(path.string(), pool).get();
+    }
+    catch (const ax::MalformedJson &)
+    {
+        malformed = true;
+    }
+    CHECK(malformed);
+    std::filesystem::remove(path);
+    bool missing = false;
+    try
+    {
+        ax::Json::parse_file_async(path.string(), pool).get();
+    }
+    catch (const std::runtime_error &)
+    {
+        missing = true;
+    }
+    CHECK(missing);
+    bool unwritable = false;
+    try
+    {
+        doc.dump_file_async((path / "no" / "such" / "dir").string(), ax::JsonFormat::Compact, 0, pool).get();
+    }
+    catch (const std::system_error &)
+    {
+        unwritable = true;
+    }
+    CHECK(unwritable);
+
+    return test::report();
+}
@@ -0,0 +1,64 @@
+#include "json.hpp"
+#include "check.hpp"
+
+#include <cstdlib>
+#include <map>
+#include <new>
+
+#if defined(__GNUC__) && !defined(__clang__)
+// The replaced operator new and delete below pair malloc and free, which GCC cannot see through
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+namespace
+{
+    size_t allocations = 0;
+}
+
+void *operator new(size_t size)
+{
+    ++allocations;
+    if (void *memory = std::malloc(size ? size : 1))
+        return memory;
+    throw std::bad_alloc();
+}
+void operator delete(void *memory) noexcept { std::free(memory); }
+void operator delete(void *memory, size_t) noexcept { std::free(memory); }
+
+namespace
+{
+    ax::Json eight_members()
+    {
+        return ax::Json::object_of(ax::member("a", 1), ax::member("b", 2), ax::member("c", 3), ax::member("d", 4),
+                                   ax::member("e", 5), ax::member("f", 6), ax::member("g", 7), ax::member("h", 8));
+    }
+
+    template <typename F>
+    size_t count(F f)
+    {
+        for (int i = 0; i < 3; ++i)
+            f(); // warm the node pool and the shape cache
+        size_t before = allocations;
+        f();
+        return allocations - before;
+    }
+}
+
+int main()
+{
+    const std::map<std::string, int> map{{"a", 1}, {"b", 2}, {"c", 3}, {"d", 4}, {"e", 5}, {"f", 6}, {"g", 7}, {"h", 8}};
+    CHECK(eight_members().dump() == ax::Json::from(map).dump());
+    CHECK((ax::Json{{"b", 1}, {"a", 2}}.dump() == R"({"a": 2, "b": 1})"));
+    CHECK(ax::Json::object_of(ax::member("b", 1), ax::member("a", 2), ax::member("b", 3)).dump() == R"({"a": 2, "b": 3})");
+    CHECK(ax::Json::array_of(1, "x", ax::Json::object_of(ax::member("k", true))).dump() == R"([1, "x", {"k": true}])");
+
+    // Each container is built in one step: a cell per member plus a few fixed allocations, no shape per prefix
+    size_t object_of = count(eight_members);
+    size_t list = count([]
+                        { return ax::Json{{"a", 1}, {"b", 2}, {"c", 3}, {"d", 4}, {"e", 5}, {"f", 6}, {"g", 7}, {"h", 8}}; });
+    size_t from = count([&]
+                        { return ax::Json::from(map); });
+    CHECK(object_of <= from + 4);
+    CHECK(list <= 2 * from);
+    return test::report();
+}
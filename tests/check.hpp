@@ -0,0 +1,30 @@
+#ifndef AX_JSON_TESTS_CHECK_HPP
+#define AX_JSON_TESTS_CHECK_HPP
+
+#include <cstdio>
+
+namespace test
+{
+    inline int failures = 0;
+
+    inline void check(bool ok, const char *condition, const char *file, int line)
+    {
+        if (!ok)
+        {
+            ++failures;
+            std::fprintf(stderr, "%s:%d: FAIL %s\n", file, line, condition);
+        }
+    }
+
+    /** It returns the exit status of the test program. */
+    inline int report()
+    {
+        if (failures)
+            std::fprintf(stderr, "%d failures\n", failures);
+        return failures ? 1 : 0;
+    }
+}
+
+#define CHECK(condition) test::check(static_cast<bool>(condition), #condition, __FILE__, __LINE__)
+
+#endif
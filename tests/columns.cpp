@@ -0,0 +1,66 @@
+#include "json.hpp"
+#include "check.hpp"
+
+#include <string>
+
+namespace
+{
+    ax::ColumnSet parse_columns(std::string_view text, std::string_view path)
+    {
+        ax::ColumnParser parser{ax::ColumnHandler(path)};
+        CHECK(parser.feed(text) && parser.finish());
+        return parser.handler().result();
+    }
+}
+
+int main()
+{
+    std::string text = R"({"data": {"events": [
+        {"id": 1, "price": 2, "name": "a", "ok": true, "big": 5, "nested": {"x": 1}},
+        {"id": 2, "price": 2.5, "name": "b", "ok": false, "big": 18446744073709551616},
+        {"id": 3, "price": 1e999, "name": "a", "ok": null, "big": 7, "extra": "late"},
+        {"id": "four", "price": 4, "name": 5, "ok": true}
+    ]}})";
+
+    // Shredding the document and shredding while parsing give the same columns
+    ax::ColumnSet set = ax::Json::parse_str(text).to_columns("/data/events");
+    ax::ColumnSet streamed = parse_columns(text, "/data/events");
+    for (const ax::ColumnSet *columns : {&set, &streamed})
+    {
+        CHECK(columns->rows == 4);
+
+        const ax::Column &id = columns->columns.at("id");
+        CHECK(id.type == ax::Column::Type::Int64);
+        CHECK(id.valid(0) && id.ints[0] == 1 && id.valid(2) && id.ints[2] == 3);
+        CHECK(!id.valid(3) && id.rejected == 1);
+
+        // Integers are promoted when fractional numbers follow, numbers out of the range of double are rejected
+        const ax::Column &price = columns->columns.at("price");
+        CHECK(price.type == ax::Column::Type::Double);
+        CHECK(price.doubles[0] == 2 && price.doubles[1] == 2.5 && price.doubles[3] == 4);
+        CHECK(!price.valid(2) && price.rejected == 1);
+
+        // An integer beyond 64 bits does not fit a column of integers
+        const ax::Column &big = columns->columns.at("big");
+        CHECK(big.type == ax::Column::Type::Int64);
+        CHECK(big.ints[0] == 5 && big.ints[2] == 7);
+        CHECK(!big.valid(1) && !big.valid(3) && big.rejected == 1);
+
+        const ax::Column &name = columns->columns.at("name");
+        CHECK(name.type == ax::Column::Type::String);
+        CHECK(name.string(0) == "a" && name.string(1) == "b" && name.string(2) == "a");
+        CHECK(name.indices[0] == name.indices[2]);
+        CHECK(!name.valid(3) && name.rejected == 1);
+
+        const ax::Column &ok = columns->columns.at("ok");
+        CHECK(ok.type == ax::Column::Type::Bool);
+        CHECK(ok.boolean(0) && !ok.boolean(1) && !ok.valid(2) && ok.boolean(3) && ok.rejected == 0);
+
+        CHECK(!columns->columns.at("nested").valid(0) && columns->columns.at("nested").rejected == 1);
+        const ax::Column &extra = columns->columns.at("extra");
+        CHECK(extra.size == 4 && !extra.valid(0) && extra.valid(2) && extra.string(2) == "late");
+    }
+
+    CHECK(ax::Json::parse_str(text).to_columns("/missing").rows == 0);
+    return test::report();
+}
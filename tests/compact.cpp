@@ -0,0 +1,68 @@
+#include "json.hpp"
+#include "check.hpp"
+
+#include <string>
+#include <vector>
+
+int main()
+{
+    ax::ParseOptions options;
+    options.retain_raw = true;
+    options.lazy_numbers = true;
+
+    ax::Json copy;
+    ax::Json handle;
+    std::string expected;
+    {
+        ax::Json doc;
+        {
+            std::string body = R"({"config": {"limits": {"rate": 100,  "burst": 1.50}}, "users": [ {"name": "a", "id": 12345678901234567890}, {"name": "b"} ]})";
+            doc = ax::Json::parse_str(body, options);
+            body.assign(body.size(), ' ');
+        }
+        for (int i = 0; i < 100; ++i)
+            doc["config"]["limits"]["rate"] = 100 + i;
+        doc["config"]["name"] = std::string(300, 'n');
+        handle = doc["config"]["limits"];
+        expected = doc.dump();
+
+        doc.compact();
+        CHECK(doc.dump() == expected);
+        copy = doc;
+    }
+
+    // The compacted nodes outlive the document they were compacted from, and the source text
+    CHECK(copy.dump() == expected);
+    CHECK(copy.at("users").dump() == R"([ {"name": "a", "id": 12345678901234567890}, {"name": "b"} ])");
+    CHECK(copy.at("users").at(0).at("id").get<uint64_t>() == 12345678901234567890u);
+    CHECK(copy.at("config").at("limits").at("burst").to<double>() == 1.5);
+    CHECK(copy.at("config").at("name").get<std::string_view>() == std::string(300, 'n'));
+
+    // Handles taken before compact still reference the document
+    handle["rate"] = 7;
+    CHECK(copy.at("config").at("limits").at("rate").get<int>() == 7);
+
+    // Containers grow after compact, and compact can run again
+    std::vector<ax::Json> added;
+    for (int i = 0; i < 100; ++i)
+        added.push_back({{"name", std::string("u").append(std::to_string(i))}});
+    copy["more"] = ax::Json::array(added);
+    for (int i = 0; i < 100; ++i)
+        copy["config"][std::string("k").append(std::to_string(i))] = i;
+    std::string grown = copy.dump();
+    copy.compact();
+    CHECK(copy.dump() == grown);
+    copy.compact();
+    CHECK(copy.dump() == grown);
+
+    // Shared nodes of a deduplicated document stay shared
+    ax::ParseOptions deduplicate;
+    deduplicate.deduplicate = true;
+    ax::Json shared = ax::Json::parse_str(R"({"a": {"x": [1, 2]}, "b": {"x": [1, 2]}})", deduplicate);
+    shared.compact();
+    CHECK(shared.at("a").get_ptr("x") == shared.at("b").get_ptr("x"));
+    shared["a"]["x"][0] = 3;
+    CHECK(shared.dump() == R"({"a": {"x": [3, 2]}, "b": {"x": [1, 2]}})");
+
+    return test::report();
+}
@@ -0,0 +1,84 @@
+#include "json.hpp"
+
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+namespace
+{
+    int failures = 0;
+
+    void check(bool ok, std::string_view what, std::string_view text)
+    {
+        if (!ok)
+        {
+            ++failures;
+            std::fprintf(stderr, "FAIL %.*s: %.*s\n", int(what.size()), what.data(), int(text.size()), text.data());
+        }
+    }
+
+    /** Documents RFC 8259 accepts. */
+    const std::string_view accepted[] = {
+        "null", "true", "false", "0", "-0", "1", "-1", "10", "123456789",
+        "0.5", "-0.5", "1.25", "1e3", "1E3", "1e+3", "1e-3", "-1.5E-10", "0e0", "0.0e00",
+        "12345678901234567890", "1e400", "1e-400",
+        "\"\"", "\" \"", "\"abc\"", "\"\\\"\"", "\"\\\\\"", "\"\\/\"", "\"\\b\\f\\n\\r\\t\"",
+        "\"\\u0000\"", "\"\\u00e9\"", "\"\\uFFFF\"", "\"\\ud83d\\ude00\"", "\"\\uD834\\uDD1E\"",
+        "\"\xc3\xa9\"", "\"\xf0\x9f\x98\x80\"",
+        "[]", "{}", "[1]", "[1,2,3]", "[[[]]]", "{\"a\":1}", "{\"a\":{\"b\":[null]}}",
+        " \t\r\n[ 1 , 2 ] \t\r\n", "{ \"a\" : 1 , \"b\" : 2 }",
+    };
+
+    /** Documents RFC 8259 rejects. */
+    const std::string_view rejected[] = {
+        "", " ", "nul", "tru", "fals", "NULL", "True", "nullx", "truefalse",
+        "01", "-01", "00", "+1", "-", ".5", "1.", "1.e3", "1e", "1e+", "1e-", "--1", "0x10", "Infinity", "NaN", "-Infinity",
+        "\"", "\"abc", "\"\\\"", "\"\\x\"", "\"\\u\"", "\"\\u12\"", "\"\\u12G4\"", "\"\\U0041\"", "'a'",
+        "\"a\tb\"", "\"a\nb\"", "\"\x01\"",
+        "\"\\ud83d\"", "\"\\ude00\"", "\"\\ud83d\\u0041\"", "\"\\ud83dx\"",
+        "\"\xc3\"", "\"\xc0\xaf\"", "\"\xed\xa0\x80\"", "\"\xff\"",
+        "[1,]", "[,1]", "[1,,2]", "{\"a\":1,}", "{,}", "[", "]", "{", "}", "[1 2]", "{\"a\" 1}", "{\"a\":}", "{a:1}",
+        "{1:1}", "[1]]", "[1] [2]", "{\"a\":1}}",
+    };
+
+    void check_string(std::string_view text, std::string_view expected)
+    {
+        auto parsed = ax::Json::try_parse(text);
+        check(parsed.has_value() && parsed->get<std::string_view>() == expected, "decoded", text);
+    }
+
+    void check_round_trip(std::string_view text)
+    {
+        auto parsed = ax::Json::try_parse(text);
+        check(parsed.has_value() && parsed->dump() == text, "round trip", text);
+    }
+}
+
+int main()
+{
+    for (std::string_view text : accepted)
+    {
+        check(ax::Json::try_parse(text).has_value(), "accept", text);
+        check(ax::Json::is_valid(text), "valid", text);
+    }
+    for (std::string_view text : rejected)
+    {
+        check(!ax::Json::try_parse(text).has_value(), "reject", text);
+        check(!ax::Json::is_valid(text), "invalid", text);
+    }
+
+    check_string("\"\\\"\\\\\\/\"", "\"\\/");
+    check_string("\"\\b\\f\\n\\r\\t\"", "\b\f\n\r\t");
+    check_string("\"\\u0041\\u00e9\"", "A\xc3\xa9");
+    check_string("\"\\u20AC\"", "\xe2\x82\xac");
+    check_string("\"\\ud83d\\ude00\"", "\xf0\x9f\x98\x80");
+    check_string(std::string_view("\"\\u0000\"", 8), std::string_view("\0", 1));
+
+    check_round_trip("[0, -1, 1.5, 12345678901234567890, 0.1234567890123456789]");
+    check_round_trip("[true, false, null, \"a\\nb\"]");
+    check_round_trip("[-0, 0.1, 1e-07]");
+
+    if (failures)
+        std::fprintf(stderr, "%d failures\n", failures);
+    return failures ? 1 : 0;
+}
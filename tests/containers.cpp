@@ -0,0 +1,70 @@
+#include "json.hpp"
+#include "check.hpp"
+
+#include <array>
+#include <list>
+#include <map>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace app
+{
+    struct Point
+    {
+        int x, y;
+        bool operator==(const Point &) const = default;
+    };
+    void to_json(ax::Json &json, const Point &p) { json = ax::Json::from(std::array<int, 2>{p.x, p.y}); }
+    bool from_json(const ax::Json &json, Point &p)
+    {
+        auto xy = json.get<std::array<int, 2>>();
+        if (xy)
+            p = {(*xy)[0], (*xy)[1]};
+        return xy.has_value();
+    }
+}
+
+int main()
+{
+    using Shapes = std::map<std::string, std::vector<app::Point>>;
+    using Row = std::tuple<int, std::string, bool>;
+    using Lists = std::unordered_map<std::string, std::list<int>>;
+    using Pair = std::pair<std::string, int>;
+    using TwoInts = std::array<int, 2>;
+    using ThreeInts = std::tuple<int, int, int>;
+
+    // Nested standard containers convert in one pass, both ways
+    Shapes shapes = {{"line", {{0, 0}, {3, 4}}}, {"dot", {{1, 1}}}};
+    ax::Json json = ax::Json::from(shapes);
+    CHECK(json.dump() == R"({"dot": [[1, 1]], "line": [[0, 0], [3, 4]]})");
+    CHECK(json.get<Shapes>() == shapes);
+
+    std::vector<std::optional<double>> values = {1.5, std::nullopt, -2};
+    CHECK(ax::Json::from(values).dump() == "[1.5, null, -2]");
+    CHECK(ax::Json::from(values).get<std::vector<std::optional<double>>>() == values);
+
+    Row row{7, "seven", true};
+    CHECK(ax::Json::from(row).dump() == R"([7, "seven", true])");
+    CHECK(ax::Json::from(row).get<Row>() == row);
+    CHECK(ax::Json::from(Pair("a", 1)).dump() == R"(["a", 1])");
+
+    Lists lists = {{"a", {1, 2}}, {"b", {}}};
+    CHECK(ax::Json::from(lists).dump() == R"({"a": [1, 2], "b": []})");
+    CHECK(ax::Json::from(lists).get<Lists>() == lists);
+
+    // Nothing converts if any element does not match
+    CHECK(!ax::Json::parse_str(R"({"line": [[0, 0], [3]]})").get<Shapes>());
+    CHECK(!ax::Json::parse_str("[1, \"2\"]").get<std::vector<int>>());
+    CHECK(!ax::Json::parse_str("[1, 2, 3]").get<TwoInts>());
+    CHECK(!ax::Json::parse_str("[1, 2]").get<ThreeInts>());
+    CHECK(!ax::Json::parse_str("{\"a\": 1}").get<std::vector<int>>());
+
+    // Json elements are views of the document
+    auto children = ax::Json::parse_str(R"([{"a": 1}, [2]])").get<std::vector<ax::Json>>();
+    CHECK(children && children->size() == 2 && (*children)[0].at("a").get<int>() == 1);
+
+    return test::report();
+}
@@ -0,0 +1,94 @@
+#include "json.hpp"
+#include "check.hpp"
+
+#include <cstdlib>
+#include <new>
+
+#if defined(__GNUC__) && !defined(__clang__)
+// The replaced operator new and delete below pair malloc and free, which GCC cannot see through
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+namespace
+{
+    size_t allocations = 0;
+}
+
+void *operator new(size_t size)
+{
+    ++allocations;
+    if (void *memory = std::malloc(size ? size : 1))
+        return memory;
+    throw std::bad_alloc();
+}
+void operator delete(void *memory) noexcept { std::free(memory); }
+void operator delete(void *memory, size_t) noexcept { std::free(memory); }
+
+int main()
+{
+    const std::string text = R"({"a": {"x": [1, 2], "y": "s"}, "b": {"x": [1, 2], "y": "s"}, "c": [{"x": [1, 2], "y": "s"}, 3]})";
+    ax::ParseOptions options;
+    options.deduplicate = true;
+
+    // Both ways of deduplicating give a document equal to the original
+    ax::Json parsed = ax::Json::parse_str(text, options);
+    ax::Json later = ax::Json::parse_str(text);
+    later.deduplicate();
+    CHECK(parsed.dump() == ax::Json::parse_str(text).dump());
+    CHECK(later.dump() == parsed.dump());
+    CHECK(parsed.at("a").get_ptr("x") == parsed.at("b").get_ptr("x"));
+    CHECK(later.at("c").at(0).get_ptr("x") == later.at("a").get_ptr("x"));
+
+    // Writes copy the shared nodes on the path, the other places keep their value
+    for (ax::Json *json : {&parsed, &later})
+    {
+        ax::Json &doc = *json;
+        doc["a"]["x"][0] = 10;
+        doc["b"]["y"] = "t";
+        doc["c"][0]["z"] = true;
+        CHECK(doc.dump() == R"({"a": {"x": [10, 2], "y": "s"}, "b": {"x": [1, 2], "y": "t"}, "c": [{"x": [1, 2], "y": "s", "z": true}, 3]})");
+    }
+
+    // Handles from const lookups borrow the shared cells: assigning to them or through them leaves the document unchanged
+    {
+        ax::Json doc = ax::Json::parse_str(text, options);
+        const std::string before = doc.dump();
+        ax::Json a = doc.at("a");
+        a = 5;
+        ax::Json b = *doc.find("b");
+        b["y"] = "t";
+        ax::Json copy = doc.at("c").at(0);
+        copy["x"][1] = 20;
+        ax::Json other;
+        other["moved"] = doc.at("a").at("x");
+        other["moved"][0] = 30;
+        doc.for_each_leaf([](ax::Json leaf)
+                          { leaf = 0; });
+        CHECK(doc.dump() == before);
+        CHECK(a.dump() == "5");
+        CHECK(b.dump() == R"({"x": [1, 2], "y": "t"})");
+        CHECK(copy.dump() == R"({"x": [1, 20], "y": "s"})");
+        CHECK(other.dump() == R"({"moved": [30, 2]})");
+    }
+
+    // Const lookups in a deduplicated document do not allocate
+    {
+        const ax::Json doc = ax::Json::parse_str(text, options);
+        const ax::Json::Key y("y");
+        size_t total = 0;
+        auto lookups = [&]
+        {
+            total += doc.at("a").at("x").at(1).to<long>().value_or(0);
+            total += doc.find("b")->at(y).to<std::string>()->size();
+            total += doc.at("c").at(0).contains("x");
+        };
+        lookups();
+        size_t before = allocations;
+        for (int i = 0; i < 100; ++i)
+            lookups();
+        CHECK(allocations == before);
+        CHECK(total == 101 * 4);
+    }
+
+    return test::report();
+}
@@ -0,0 +1,67 @@
+#include "json.hpp"
+#include "check.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace
+{
+    enum class Level : uint8_t
+    {
+        Low = 1,
+        High = 2
+    };
+}
+
+int main()
+{
+    const ax::Json doc = ax::Json::parse_str(R"({"byte": 255, "big": 256, "neg": -1, "exp": 1e3, "whole": 2.0, "frac": 2.5,
+        "huge": 1e400, "long": 12345678901234567890, "text": "42", "flag": true, "none": null, "level": 2, "list": [1]})");
+
+    // Integers are range checked and must be whole numbers
+    CHECK(doc.at("byte").get<uint8_t>() == 255);
+    CHECK(!doc.at("big").get<uint8_t>());
+    CHECK(doc.at("big").get<int16_t>() == 256);
+    CHECK(!doc.at("neg").get<unsigned>());
+    CHECK(doc.at("neg").get<int8_t>() == -1);
+    CHECK(doc.at("exp").get<int>() == 1000);
+    CHECK(doc.at("whole").get<long>() == 2);
+    CHECK(!doc.at("frac").get<int>());
+    CHECK(!doc.at("huge").get<int64_t>());
+    CHECK(!doc.at("long").get<int64_t>());
+    CHECK(doc.at("long").get<uint64_t>() == 12345678901234567890u);
+
+    // Floating point types from numbers in range
+    CHECK(doc.at("frac").get<double>() == 2.5);
+    CHECK(doc.at("frac").get<float>() == 2.5f);
+    CHECK(doc.at("byte").get<double>() == 255.0);
+    CHECK(!doc.at("huge").get<double>());
+
+    // The JSON type must match, unlike to<T>
+    CHECK(!doc.at("text").get<int>());
+    CHECK(doc.at("text").to<int>() == 42);
+    CHECK(doc.at("text").get<std::string_view>() == "42");
+    CHECK(!doc.at("byte").get<std::string_view>());
+    CHECK(doc.at("flag").get<bool>() == true);
+    CHECK(!doc.at("byte").get<bool>());
+    CHECK(!doc.at("none").get<int>());
+    CHECK(!doc.at("none").get<std::string_view>());
+    CHECK(!doc.at("list").get<int>());
+    CHECK(doc.at("level").get<Level>() == Level::High);
+    CHECK(!doc.at("big").get<Level>());
+
+    // get_if leaves its argument unchanged when the value does not convert
+    int value = 7;
+    CHECK(!doc.at("frac").get_if(value) && value == 7);
+    CHECK(doc.at("exp").get_if(value) && value == 1000);
+    std::string_view view = "unchanged";
+    CHECK(!doc.at("flag").get_if(view) && view == "unchanged");
+
+    // Scalars never throw
+    static_assert(noexcept(doc.get<int>()));
+    static_assert(noexcept(doc.get<std::string_view>()));
+    static_assert(noexcept(doc.get_if(value)));
+
+    return test::report();
+}
@@ -0,0 +1,71 @@
+#include "json.hpp"
+#include "check.hpp"
+
+#include <thread>
+#include <vector>
+
+int main()
+{
+    // A default constructed Json aliases like any other handle once copied, assigned or inserted
+    {
+        ax::Json parent;
+        ax::Json child;
+        parent["c"] = child;
+        child["x"] = 1;
+        CHECK(parent.dump() == R"({"c": {"x": 1}})");
+    }
+    {
+        ax::Json h;
+        ax::Json h2 = h;
+        h2["y"] = 2;
+        CHECK(h.dump() == R"({"y": 2})");
+    }
+    {
+        ax::Json h;
+        ax::Json h2;
+        h2 = h;
+        h2["y"] = 2;
+        CHECK(h.dump() == R"({"y": 2})");
+    }
+    {
+        ax::Json d;
+        ax::Json object = {{"e", d}};
+        d["f"] = 1;
+        CHECK(object.dump() == R"({"e": {"f": 1}})");
+    }
+    {
+        ax::Json a;
+        ax::Json array = ax::Json::array({a});
+        a["g"] = 1;
+        CHECK(array.dump() == R"([{"g": 1}])");
+    }
+    {
+        ax::Json a{{"k", 1}};
+        ax::Json b = a;
+        b["k"] = 2;
+        CHECK(a.dump() == R"({"k": 2})");
+        ax::Json c = a.clone();
+        c["k"] = 3;
+        CHECK(a.dump() == R"({"k": 2})");
+    }
+
+    // Concurrent readers of one const default Json never write to it
+    {
+        const ax::Json shared;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+            threads.emplace_back([&]
+                                 {
+                                     for (int i = 0; i < 1000; ++i)
+                                     {
+                                         ax::Json copy = shared;
+                                         test::check(shared.dump() == "{}" && !shared.contains("x"), "shared reads", __FILE__, __LINE__);
+                                         copy["x"] = i;
+                                     } });
+        for (auto &thread : threads)
+            thread.join();
+        CHECK(shared.dump() == "{}");
+        CHECK(ax::Json().dump() == "{}");
+    }
+    return test::report();
+}
@@ -0,0 +1,110 @@
+#include "json.hpp"
+#include "check.hpp"
+
+#include <coroutine>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // Every read and write suspends until main resumes it, like a socket that is not ready yet
+    std::deque<std::coroutine_handle<>> ready;
+
+    struct Pause
+    {
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle) { ready.push_back(handle); }
+        void await_resume() const noexcept {}
+    };
+
+    struct Connection
+    {
+        std::vector<std::string> input;
+        size_t next = 0;
+        std::vector<std::string> output;
+
+        ax::Task<std::string> read()
+        {
+            co_await Pause();
+            co_return next < input.size() ? input[next++] : std::string();
+        }
+        ax::Task<> write(std::string_view chunk)
+        {
+            co_await Pause();
+            output.emplace_back(chunk);
+        }
+    };
+
+    // A coroutine started at once and never awaited, that keeps its error for main
+    struct Detached
+    {
+        struct promise_type
+        {
+            Detached get_return_object() { return {}; }
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception() { std::terminate(); }
+        };
+    };
+
+    Detached echo(Connection &connection, std::string &error, size_t chunk_size)
+    {
+        try
+        {
+            ax::Json request = co_await ax::Json::parse_async(connection);
+            ax::Json response = {{"request", request}, {"ok", true}};
+            co_await response.dump_async(connection, ax::JsonFormat::Compact, 0, chunk_size);
+        }
+        catch (const ax::MalformedJson &malformed)
+        {
+            error = malformed.what();
+        }
+    }
+
+    void run()
+    {
+        while (!ready.empty())
+        {
+            auto handle = ready.front();
+            ready.pop_front();
+            handle.resume();
+        }
+    }
+}
+
+int main()
+{
+    // Chunks split anywhere, even inside strings, escapes and numbers
+    const std::string text = R"({"name": "a \"quoted\" é string", "values": [1, -2.5e3, true, null], "nested": {"empty": {}}})";
+    for (size_t size : {1, 3, 7, 1000})
+    {
+        Connection connection;
+        for (size_t i = 0; i < text.size(); i += size)
+            connection.input.push_back(text.substr(i, size));
+        std::string error;
+        echo(connection, error, 16);
+        run();
+        CHECK(error.empty());
+        std::string output;
+        for (auto &chunk : connection.output)
+            output += chunk;
+        CHECK(output == ax::Json({{"request", ax::Json::parse_str(text)}, {"ok", true}}).dump(ax::JsonFormat::Compact));
+        CHECK(connection.output.size() > 1);
+    }
+
+    // A malformed or truncated text fails the task
+    for (std::string bad : {R"({"a": [1, 2}})", R"({"a": [1, 2)"})
+    {
+        Connection connection;
+        connection.input = {bad.substr(0, 4), bad.substr(4)};
+        std::string error;
+        echo(connection, error, 16);
+        run();
+        CHECK(!error.empty());
+        CHECK(connection.output.empty());
+    }
+
+    return test::report();
+}
@@ -0,0 +1,65 @@
+#include "json.hpp"
+#include "check.hpp"
+
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+
+namespace
+{
+    std::string gather(ax::IoVecOutput &output)
+    {
+        std::string text;
+        for (const iovec &segment : output.segments())
+            text.append(static_cast<const char *>(segment.iov_base), segment.iov_len);
+        return text;
+    }
+}
+
+int main()
+{
+    ax::Json doc;
+    doc["long"] = std::string(1000, 'a');
+    doc["short"] = "b";
+    doc["list"] = ax::Json::array_of(1, 2.5, "c", std::string(500, 'd'));
+    const ax::Json &view = doc;
+
+    // The segments hold the same text as dump, long strings are referenced in place
+    for (auto format : {ax::JsonFormat::Spaced, ax::JsonFormat::Compact, ax::JsonFormat::Pretty})
+    {
+        ax::IoVecOutput output(64);
+        doc.dump(output.buffer(), format);
+        CHECK(gather(output) == doc.dump(format));
+        CHECK(output.size() == doc.dump(format).size());
+        const char *stored = view.at("long").get<std::string_view>()->data();
+        bool referenced = false;
+        for (const iovec &segment : output.segments())
+            referenced |= segment.iov_base == stored;
+        CHECK(referenced);
+    }
+
+    // Strings passed to JsonWriter are copied: they may be destroyed before the segments are used
+    ax::IoVecOutput written;
+    {
+        ax::JsonWriter writer(written.buffer(), ax::JsonFormat::Compact);
+        std::string key(300, 'k'), value(300, 'v');
+        writer.begin_object().key(key).value(value).end_object();
+        key.assign(300, 'x');
+        value.assign(300, 'y');
+    }
+    CHECK(gather(written) == "{\"" + std::string(300, 'k') + "\":\"" + std::string(300, 'v') + "\"}");
+
+    // write_to sends every segment through writev
+    ax::IoVecOutput output(16);
+    doc.dump(output.buffer());
+    std::FILE *file = std::tmpfile();
+    CHECK(file != nullptr);
+    output.write_to(fileno(file));
+    std::string read(output.size(), '\0');
+    std::rewind(file);
+    CHECK(std::fread(read.data(), 1, read.size(), file) == read.size());
+    CHECK(read == doc.dump());
+    std::fclose(file);
+
+    return test::report();
+}
@@ -0,0 +1,56 @@
+#include "json.hpp"
+#include "check.hpp"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+int main()
+{
+    ax::ParseOptions options;
+    options.lazy_numbers = true;
+    const std::string text = "[1.50, 1E+3, -0.0, 12345678901234567890, 0.1234567890123456789, 42, \"17\", 9223372036854775808, 1e400]";
+    const ax::Json doc = ax::Json::parse_str(text, options);
+
+    // Numbers are written back exactly as they were
+    CHECK(doc.dump(ax::JsonFormat::Compact) == "[1.50,1E+3,-0.0,12345678901234567890,0.1234567890123456789,42,\"17\",9223372036854775808,1e400]");
+
+    // They convert on use like eager numbers do
+    const ax::Json eager = ax::Json::parse_str(text);
+    for (size_t i = 0; i < 9; ++i)
+    {
+        CHECK(doc.at(i).to<long>() == eager.at(i).to<long>());
+        CHECK(doc.at(i).to<double>() == eager.at(i).to<double>());
+        CHECK(doc.at(i).to<ax::Number>() == eager.at(i).to<ax::Number>());
+        CHECK(doc.at(i).get<double>() == eager.at(i).get<double>());
+        CHECK(doc.at(i).get<int64_t>() == eager.at(i).get<int64_t>());
+    }
+    CHECK(doc.at(0).to<double>() == 1.5);
+    CHECK(doc.at(1).to<long>() == 1000);
+    CHECK(doc.at(5).get<int>() == 42);
+    CHECK(doc.at(6).to<long>() == 17);
+    CHECK(!doc.at(6).get<int>());
+    CHECK(!doc.at(7).to<long>());
+    CHECK(!doc.at(7).get<int64_t>());
+    CHECK(doc.at(3).get<uint64_t>() == 12345678901234567890u);
+
+    // Conversions are cached, concurrent first uses agree
+    const ax::Json shared = ax::Json::parse_str(text, options);
+    std::vector<std::thread> threads;
+    std::vector<int> agreed(8, 0);
+    for (int t = 0; t < 8; ++t)
+        threads.emplace_back([&, t]
+                             { agreed[t] = shared.at(0).to<double>() == 1.5 && shared.at(1).to<long>() == 1000 && shared.at(3).to<double>() == 12345678901234567890.0; });
+    for (auto &thread : threads)
+        thread.join();
+    for (int ok : agreed)
+        CHECK(ok);
+
+    // Assigned numbers replace the text
+    ax::Json copy = ax::Json::parse_str(text, options);
+    copy[0] = 2;
+    copy[1] = 0.5;
+    CHECK(copy.dump(ax::JsonFormat::Compact).starts_with("[2,0.5,-0.0,"));
+
+    return test::report();
+}
@@ -0,0 +1,108 @@
+#include "json.hpp"
+#include "check.hpp"
+
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <vector>
+
+#if defined(__GNUC__) && !defined(__clang__)
+// The replaced operator new and delete below pair malloc and free, which GCC cannot see through
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+namespace
+{
+    // Every block starts with its size, so that the bytes still allocated can be counted
+    constexpr size_t header = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+    std::atomic<size_t> allocations{0};
+    std::atomic<long long> live{0};
+}
+
+void *operator new(size_t size)
+{
+    ++allocations;
+    char *memory = static_cast<char *>(std::malloc(size + header));
+    if (!memory)
+        throw std::bad_alloc();
+    *reinterpret_cast<size_t *>(memory) = size;
+    live += size;
+    return memory + header;
+}
+void operator delete(void *memory) noexcept
+{
+    if (!memory)
+        return;
+    char *block = static_cast<char *>(memory) - header;
+    live -= *reinterpret_cast<size_t *>(block);
+    std::free(block);
+}
+void operator delete(void *memory, size_t) noexcept { operator delete(memory); }
+
+namespace
+{
+    ax::Json many_nodes()
+    {
+        std::vector<ax::Json> items;
+        items.reserve(100000);
+        for (int i = 0; i < 100000; ++i)
+            items.push_back(ax::Json::object_of(ax::member("id", i), ax::member("name", "n")));
+        return ax::Json::array(items);
+    }
+}
+
+int main()
+{
+    constexpr long long slack = 64 << 10;
+
+    // Overwriting existing fields allocates nothing once the lists are warm
+    ax::Json status = {{"load", 0}, {"state", "idle"}};
+    for (int i = 0; i < 10; ++i)
+    {
+        status["load"] = i;
+        status["state"] = "busy";
+    }
+    size_t before = allocations;
+    for (int i = 0; i < 1000; ++i)
+    {
+        status["load"] = i;
+        status["state"] = i % 2 ? "busy" : "idle";
+    }
+    CHECK(allocations == before);
+
+    // Releasing a large document keeps at most max_free_bytes in the lists of the thread, trim returns them
+    ax::NodePool::trim();
+    long long baseline = live;
+    {
+        ax::Json doc = many_nodes();
+        CHECK(live - baseline > 4 * static_cast<long long>(ax::NodePool::max_free_bytes));
+    }
+    CHECK(live - baseline <= static_cast<long long>(ax::NodePool::max_free_bytes) + slack);
+    ax::NodePool::trim();
+    CHECK(live - baseline <= slack);
+
+    // Nodes released on another thread join the lists of that thread, under the same cap
+    baseline = live;
+    ax::Json moved = many_nodes();
+    long long size = live - baseline, kept = 0;
+    std::thread([&]
+                {
+                    long long start = live;
+                    moved = ax::Json();
+                    kept = size + (live - start);
+                    ax::NodePool::trim(); })
+        .join();
+    CHECK(kept <= static_cast<long long>(ax::NodePool::max_free_bytes) + slack);
+    CHECK(live - baseline <= slack);
+
+    // compact trims the lists of the calling thread
+    ax::Json doc = many_nodes();
+    for (int i = 0; i < 1000; ++i)
+        doc[i] = i;
+    long long modified = live;
+    doc.compact();
+    CHECK(live < modified);
+    CHECK(doc.at(999).get<int>() == 999 && doc.at(1000).at("id").get<int>() == 1000);
+
+    return test::report();
+}
@@ -0,0 +1,68 @@
+#include "json.hpp"
+#include "check.hpp"
+
+#include <cmath>
+#include <string>
+#include <string_view>
+
+namespace
+{
+    // It checks the kind of text as a Number, and that it is written back as expected
+    void check_number(std::string_view text, ax::Number::Kind kind, std::string_view written)
+    {
+        auto number = ax::Number::parse(text);
+        CHECK(number.has_value());
+        if (!number)
+            return;
+        CHECK(number->kind() == kind);
+        CHECK(number->to_string() == written);
+        CHECK(ax::Number::parse(number->to_string()) == number);
+    }
+}
+
+int main()
+{
+    using Kind = ax::Number::Kind;
+
+    // Small values take the fast paths, the others keep their digits
+    check_number("42", Kind::Int64, "42");
+    check_number("-9223372036854775808", Kind::Int64, "-9223372036854775808");
+    check_number("100e-2", Kind::Int64, "1");
+    check_number("0.5", Kind::Double, "0.5");
+    check_number("-0", Kind::Double, "-0");
+    check_number("9223372036854775808", Kind::Decimal, "9223372036854775808");
+    check_number("12345678901234567890", Kind::Decimal, "12345678901234567890");
+    check_number("0.1234567890123456789", Kind::Decimal, "0.1234567890123456789");
+    check_number("1e400", Kind::Decimal, "1e400");
+    check_number("-1.5e-400", Kind::Decimal, "-1.5e-400");
+    check_number("1.2345678901234567e300", Kind::Decimal, "1.2345678901234567e300");
+
+    auto decimal = ax::Number::parse("-12.3400e5");
+    CHECK(decimal && decimal->kind() == Kind::Int64 && decimal->to_int64() == -1234000);
+    auto exact = ax::Number::parse("-0.00012345678901234567890");
+    CHECK(exact && exact->digits() == "1234567890123456789" && exact->exponent() == -22 && exact->negative());
+    CHECK(ax::Number::parse("1e400")->to_double() == INFINITY);
+    CHECK(ax::Number::parse("1e99999999999999999999")->exponent() == int64_t(1) << 58);
+    CHECK(ax::Number::parse("1.0") == ax::Number(int64_t(1)));
+    CHECK(ax::Number::parse("0.5") == ax::Number(0.5));
+    CHECK(!(ax::Number::parse("12345678901234567890") == ax::Number(12345678901234567890.0)));
+
+    // Text that is not a JSON number
+    for (std::string_view text : {"", "-", "+1", "01", "-01", "00", "1.", ".5", "1e", "1e+", "0x10", "1 ", "NaN"})
+        CHECK(!ax::Number::parse(text));
+
+    // Documents keep exact numbers, and Number values convert both ways
+    const std::string text = R"({"amount": 0.1234567890123456789, "id": 12345678901234567890, "small": 7})";
+    ax::Json payment = ax::Json::parse_str(text);
+    CHECK(payment.dump() == text);
+    CHECK(payment.at("id").to<ax::Number>() == ax::Number::parse("12345678901234567890"));
+    CHECK(payment.at("small").to<ax::Number>() == ax::Number(int64_t(7)));
+    CHECK(payment.at("id").get<uint64_t>() == 12345678901234567890u);
+    payment["total"] = ax::Number::parse("1e400").value();
+    CHECK(payment.at("total").dump() == "1e400");
+    char buffer[ax::Number::max_inline_chars];
+    auto written = ax::Number(-1.5e-300).to_chars(buffer, buffer + sizeof(buffer));
+    CHECK(written.ec == std::errc() && std::string_view(buffer, written.ptr) == "-1.5e-300");
+
+    return test::report();
+}
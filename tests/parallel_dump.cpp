@@ -0,0 +1,55 @@
+#include "json.hpp"
+#include "check.hpp"
+
+#include <string>
+#include <vector>
+
+namespace
+{
+    std::string dump_parallel(const ax::Json &json, ax::JsonFormat format, ax::ThreadPool &pool, size_t chunk_size = 4096)
+    {
+        std::string text;
+        {
+            ax::OutputBuffer out = ax::OutputBuffer::to_string(text, chunk_size);
+            json.dump_parallel(out, format, 2, pool);
+        }
+        return text;
+    }
+}
+
+int main()
+{
+    ax::ThreadPool pool(4);
+
+    std::vector<ax::Json> items;
+    ax::Json object;
+    for (int i = 0; i < 5000; ++i)
+    {
+        items.push_back({{"id", i}, {"name", "item " + std::to_string(i)}, {"tags", ax::Json::array_of(1, 2.5, nullptr, true)}});
+        object[std::string("k").append(std::to_string(i))] = ax::Json::array_of(i, "x");
+    }
+    ax::Json array = ax::Json::array(items);
+    CHECK(array.at(4999).at("id").get<int>() == 4999);
+
+    // The output equals the sequential output in every format, whatever the chunk size of the buffer
+    for (auto format : {ax::JsonFormat::Spaced, ax::JsonFormat::Compact, ax::JsonFormat::Pretty})
+    {
+        CHECK(dump_parallel(array, format, pool) == array.dump(format, 2));
+        CHECK(dump_parallel(object, format, pool) == object.dump(format, 2));
+        CHECK(dump_parallel(array, format, pool, 64) == array.dump(format, 2));
+    }
+    ax::Json small = ax::Json::array_of(1, 2, 3);
+    CHECK(dump_parallel(small, ax::JsonFormat::Compact, pool) == "[1,2,3]");
+
+    // It can run inside a pool task without waiting for itself
+    ax::TaskGroup group(pool);
+    std::string results[8];
+    for (auto &result : results)
+        group.run([&]
+                  { result = dump_parallel(array, ax::JsonFormat::Compact, pool); });
+    group.wait();
+    for (auto &result : results)
+        CHECK(result == array.dump(ax::JsonFormat::Compact));
+
+    return test::report();
+}
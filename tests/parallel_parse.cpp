@@ -0,0 +1,69 @@
+#include "json.hpp"
+#include "check.hpp"
+
+#include <string>
+
+namespace
+{
+    ax::ParseError parse_error(std::string_view text, bool parallel, ax::ThreadPool &pool)
+    {
+        try
+        {
+            parallel ? ax::Json::parse_parallel(text, pool) : ax::Json::parse_str(std::string(text));
+        }
+        catch (const ax::MalformedJson &error)
+        {
+            if (error.error())
+                return *error.error();
+        }
+        return {};
+    }
+}
+
+int main()
+{
+    ax::ThreadPool pool(4);
+
+    // Arrays and objects larger than the parallel threshold parse like the sequential parser
+    std::string array = "[";
+    for (int i = 0; i < 40000; ++i)
+        array += (i ? "," : "") + std::string(R"({"id": )") + std::to_string(i) + R"(, "name": "item \"\\ )" + std::to_string(i) + R"(", "tags": [1, 2.5, null, true]})";
+    array += "]";
+    CHECK(array.size() > (1 << 20));
+    CHECK(ax::Json::parse_parallel(array, pool).dump() == ax::Json::parse_str(std::string(array)).dump());
+
+    std::string object = " {";
+    for (int i = 0; i < 40000; ++i)
+        object += (i ? ",\n" : "") + std::string("\"k") + std::to_string(i % 30000) + R"(": [{"a": "x,y]"}, )" + std::to_string(i) + "]";
+    object += "} ";
+    CHECK(ax::Json::parse_parallel(object, pool).dump() == ax::Json::parse_str(std::string(object)).dump());
+
+    // Top level elements inside the first index chunk are split points too: one small element, then one large one
+    std::string skewed = "[";
+    for (int i = 0; i < 2000; ++i)
+        skewed += std::to_string(i) + ",";
+    skewed += "\"" + std::string(1 << 21, 'z') + "\"]";
+    CHECK(ax::Json::parse_parallel(skewed, pool).dump() == ax::Json::parse_str(std::string(skewed)).dump());
+
+    // Errors are located in the whole text, as parse reports them
+    std::string broken = array;
+    broken.replace(broken.find("null", broken.size() / 2), 4, "nul?");
+    ax::ParseError parallel = parse_error(broken, true, pool), sequential = parse_error(broken, false, pool);
+    CHECK(parallel.offset == sequential.offset);
+    CHECK(parallel.kind == sequential.kind);
+    CHECK(parallel.offset > 0);
+    std::string unterminated = array.substr(0, array.size() - 1);
+    CHECK(parse_error(unterminated, true, pool).offset == parse_error(unterminated, false, pool).offset);
+
+    // It can run inside a pool task without waiting for itself
+    ax::TaskGroup group(pool);
+    std::string results[8];
+    for (auto &result : results)
+        group.run([&]
+                  { result = ax::Json::parse_parallel(array, pool).dump(); });
+    group.wait();
+    for (auto &result : results)
+        CHECK(result == ax::Json::parse_str(std::string(array)).dump());
+
+    return test::report();
+}
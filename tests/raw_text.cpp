@@ -0,0 +1,50 @@
+#include "json.hpp"
+#include "check.hpp"
+
+#include <string>
+
+int main()
+{
+    ax::ParseOptions options;
+    options.retain_raw = true;
+
+    ax::Json doc;
+    {
+        // The source text is released with the last container that retains it, not before
+        std::string body = R"({"meta":  {"id": 7,   "tags": [ "a",  "b" ]},  "data": [ {"x": 1.50} , {"y": [ ]} ]})";
+        doc = ax::Json::parse_str(body, options);
+        body.assign(body.size(), ' ');
+    }
+    const std::string original = R"({"meta":  {"id": 7,   "tags": [ "a",  "b" ]},  "data": [ {"x": 1.50} , {"y": [ ]} ]})";
+
+    // Untouched containers are written as their original text, whatever the format
+    CHECK(doc.dump() == original);
+    CHECK(doc.dump(ax::JsonFormat::Pretty) == original);
+    CHECK(doc.at("data").at(1).dump(ax::JsonFormat::Compact) == R"({"y": [ ]})");
+    std::string parallel;
+    {
+        ax::OutputBuffer out = ax::OutputBuffer::to_string(parallel);
+        doc.dump_parallel(out, ax::JsonFormat::Compact);
+    }
+    CHECK(parallel == original);
+
+    // A modification re-serializes the containers on its path only
+    doc["meta"]["proxy"] = "edge-1";
+    CHECK(doc.dump() == R"({"data": [ {"x": 1.50} , {"y": [ ]} ], "meta": {"id": 7, "proxy": "edge-1", "tags": [ "a",  "b" ]}})");
+    doc["data"][0]["x"] = 2;
+    CHECK(doc.dump(ax::JsonFormat::Compact) == R"({"data":[{"x":2},{"y": [ ]}],"meta":{"id":7,"proxy":"edge-1","tags":[ "a",  "b" ]}})");
+
+    // transform and discard_raw drop the original text of the whole subtree
+    ax::Json other = ax::Json::parse_str(original, options);
+    other.discard_raw();
+    CHECK(other.dump(ax::JsonFormat::Compact) == R"({"data":[{"x":1.5},{"y":[]}],"meta":{"id":7,"tags":["a","b"]}})");
+    ax::Json transformed = ax::Json::parse_str(original, options);
+    transformed.transform([](const ax::Json &leaf)
+                          { return leaf; });
+    CHECK(transformed.dump(ax::JsonFormat::Compact) == other.dump(ax::JsonFormat::Compact));
+
+    // Without the option nothing is retained
+    CHECK(ax::Json::parse_str(original).dump(ax::JsonFormat::Compact) == other.dump(ax::JsonFormat::Compact));
+
+    return test::report();
+}
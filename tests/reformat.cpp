@@ -0,0 +1,58 @@
+#include "json.hpp"
+#include "check.hpp"
+
+#include <string>
+#include <string_view>
+
+namespace
+{
+    // It reformats text fed in chunks of size bytes
+    std::string reformat(std::string_view text, ax::JsonFormat format, unsigned indent, size_t size, bool *closed = nullptr)
+    {
+        std::string result;
+        {
+            ax::OutputBuffer out = ax::OutputBuffer::to_string(result);
+            ax::JsonReformatter reformatter(out, format, indent);
+            for (size_t i = 0; i < text.size(); i += size)
+                reformatter.feed(text.substr(i, size));
+            bool finished = reformatter.finish();
+            if (closed)
+                *closed = finished;
+        }
+        return result;
+    }
+}
+
+int main()
+{
+    // Text in the canonical form of the serializer is reformatted exactly like the document would be dumped
+    const std::string text = " {\n\t\"a\" : [ 1 , -2.5 , true , null , [ ] , { } ] ,\r\n \"b\" : { \"c d\" : \"x \\\" \\\\ \\n y\" , \"e\":[[1,2],[3]] } } ";
+    ax::Json doc = ax::Json::parse_str(text);
+    CHECK(ax::minify(text) == doc.dump(ax::JsonFormat::Compact));
+    CHECK(ax::prettify(text, 2) == doc.dump(ax::JsonFormat::Pretty, 2));
+    CHECK(ax::prettify(text) == doc.dump(ax::JsonFormat::Pretty, 4));
+    for (size_t size : {1, 2, 5, 16, 17})
+    {
+        CHECK(reformat(text, ax::JsonFormat::Compact, 0, size) == doc.dump(ax::JsonFormat::Compact));
+        CHECK(reformat(text, ax::JsonFormat::Spaced, 0, size) == doc.dump(ax::JsonFormat::Spaced));
+        CHECK(reformat(text, ax::JsonFormat::Pretty, 3, size) == doc.dump(ax::JsonFormat::Pretty, 3));
+    }
+
+    // Strings and numbers are copied as they are, including whitespace inside strings longer than a SIMD block
+    const std::string verbatim = "[ \"\\u00e9\\/ \t  spaced   out   string  \" , 1.50 , 1E+3 , -0 ]";
+    CHECK(ax::minify(verbatim) == "[\"\\u00e9\\/ \t  spaced   out   string  \",1.50,1E+3,-0]");
+    CHECK(reformat(verbatim, ax::JsonFormat::Compact, 0, 3) == ax::minify(verbatim));
+
+    // finish reports texts that end inside a string or a container
+    bool closed = true;
+    reformat("[1, {\"a\": 2}", ax::JsonFormat::Compact, 0, 4, &closed);
+    CHECK(!closed);
+    reformat("[\"abc]", ax::JsonFormat::Compact, 0, 4, &closed);
+    CHECK(!closed);
+    reformat("[1]]", ax::JsonFormat::Compact, 0, 4, &closed);
+    CHECK(!closed);
+    reformat("[1]", ax::JsonFormat::Compact, 0, 4, &closed);
+    CHECK(closed);
+
+    return test::report();
+}
@@ -0,0 +1,77 @@
+#include "json.hpp"
+#include "check.hpp"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+int main()
+{
+    // Records of several shapes, where "price" sits at a different slot or is missing
+    const ax::Json records = ax::Json::parse_str(R"([
+        {"id": 1, "price": 10},
+        {"a": 0, "id": 2, "price": 20},
+        {"id": 3, "price": 30},
+        {"id": 4},
+        {"a": 0, "b": 0, "id": 5, "price": 50, "z": 0}
+    ])");
+    const ax::Json::Key price("price"), id("id");
+    for (int round = 0; round < 3; ++round)
+    {
+        long total = 0;
+        for (size_t i = 0; i < 5; ++i)
+        {
+            const ax::Json record = records.at(i);
+            CHECK(record.at(id).get<int>() == int(i + 1));
+            if (auto value = record.find(price))
+                total += value->get<long>().value_or(0);
+            CHECK(record.contains(price) == (i != 3));
+        }
+        CHECK(total == 110);
+    }
+
+    // Objects that change shape, and an object large enough for a private shape that is modified in place
+    ax::Json record = {{"id", 1}, {"price", 10}};
+    CHECK(record.at(price).get<int>() == 10);
+    record["aaa"] = 0;
+    CHECK(record.at(price).get<int>() == 10);
+    ax::Json large;
+    for (int i = 0; i < 200; ++i)
+        large[std::string("k").append(std::to_string(1000 + i))] = i;
+    large["price"] = -1;
+    const ax::Json::Key last("k1199");
+    CHECK(large.at(last).get<int>() == 199);
+    CHECK(large.at(price).get<int>() == -1);
+    large["a"] = 0; // before every other key
+    CHECK(large.at(last).get<int>() == 199);
+    CHECK(large.at(price).get<int>() == -1);
+
+    // operator[] with a Key inserts a missing key
+    ax::Json item = {{"id", 9}};
+    item[price] = 90;
+    CHECK(item.dump() == R"({"id": 9, "price": 90})");
+    item[price] = 91;
+    CHECK(item.at(price).get<int>() == 91);
+
+    // Objects built on several threads intern the same shapes, and every thread uses its own Key
+    std::vector<ax::Json> built(4);
+    std::vector<int> sums(4, 0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+        threads.emplace_back([&, t]
+                             {
+                                 built[t] = ax::Json::object_of(ax::member("id", t), ax::member("price", t * 10));
+                                 const ax::Json::Key local("price");
+                                 for (size_t i = 0; i < 5; ++i)
+                                     if (auto value = records.at(i).find(local))
+                                         sums[t] += value->get<int>().value_or(0); });
+    for (auto &thread : threads)
+        thread.join();
+    for (int t = 0; t < 4; ++t)
+    {
+        CHECK(sums[t] == 110);
+        CHECK(built[t].at(price).get<int>() == t * 10);
+    }
+
+    return test::report();
+}
@@ -0,0 +1,75 @@
+#include "json.hpp"
+#include "check.hpp"
+
+#include <string>
+#include <string_view>
+
+// Built twice: as is, and with -fno-exceptions, where try_parse is the only way to reject untrusted input
+namespace
+{
+    void check_error(std::string_view text, ax::ParseError::Kind kind, size_t offset, size_t line, size_t column)
+    {
+        auto result = ax::Json::try_parse(text);
+        CHECK(!result);
+        if (result)
+            return;
+        const ax::ParseError &error = result.error();
+        CHECK(error.kind == kind);
+        CHECK(error.offset == offset);
+        CHECK(error.line == line);
+        CHECK(error.column == column);
+        CHECK(error.message() != nullptr);
+    }
+}
+
+int main()
+{
+    using Kind = ax::ParseError::Kind;
+
+    auto result = ax::Json::try_parse(R"({"a": [1, 2.5, "x"], "b": null})");
+    CHECK(result.has_value());
+    CHECK(result->dump() == R"({"a": [1, 2.5, "x"], "b": null})");
+
+    // Every kind of error, with its position in bytes, and in lines and columns. Strings, numbers and literals are checked
+    // as whole tokens: their errors are reported where the token ends
+    check_error("", Kind::UnexpectedEnd, 0, 1, 1);
+    check_error("[1, 2", Kind::UnexpectedEnd, 5, 1, 6);
+    check_error("[1, ?]", Kind::UnexpectedCharacter, 4, 1, 5);
+    check_error("{\n  \"a\": 1\n}\nx", Kind::TrailingCharacters, 13, 4, 1);
+    check_error("{\n  \"a\": \"\\q\"\n}", Kind::InvalidString, 12, 2, 11);
+    check_error("[\n\n  01]", Kind::InvalidNumber, 7, 3, 5);
+    check_error("[tru]", Kind::InvalidLiteral, 4, 1, 5);
+
+    // Options apply as with parse_str
+    ax::ParseOptions options;
+    options.retain_raw = true;
+    options.lazy_numbers = true;
+    std::string text = R"({"n": 1.50, "o": {"k":  [1]}})";
+    auto raw = ax::Json::try_parse(text, options);
+    CHECK(raw && raw->dump() == text);
+    CHECK(raw && raw->at("n").to<double>() == 1.5);
+
+    // The incremental parser reports offsets from the start of the whole text
+    ax::JsonParser parser;
+    CHECK(parser.feed("[1, 2, "));
+    CHECK(parser.feed("3, "));
+    CHECK(!parser.feed("x]"));
+    CHECK(parser.error_kind() == Kind::UnexpectedCharacter);
+    CHECK(parser.error_offset() == 10);
+
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS)
+    // parse_str throws the same error
+    bool thrown = false;
+    try
+    {
+        ax::Json::parse_str(std::string("[\n\n  01]"));
+    }
+    catch (const ax::MalformedJson &error)
+    {
+        thrown = error.error() && error.error()->offset == 7 && error.error()->line == 3 && error.error()->kind == Kind::InvalidNumber;
+    }
+    CHECK(thrown);
+#endif
+
+    return test::report();
+}
@@ -0,0 +1,63 @@
+#include "json.hpp"
+#include "check.hpp"
+
+#include <string>
+#include <string_view>
+
+namespace
+{
+    // It feeds text to a validator one byte at a time
+    bool valid_bytewise(std::string_view text)
+    {
+        ax::JsonValidator validator;
+        for (char ch : text)
+            if (!validator.feed(std::string_view(&ch, 1)))
+                return false;
+        return validator.finish();
+    }
+}
+
+int main()
+{
+    const std::string_view texts[] = {
+        R"({"a": [1, -2.5e-3, true, false, null], "b": {"c": "\u00e9\ud83d\ude00 \" \\"}})",
+        "[]", " 0 ", "\"\xe2\x82\xac\"",
+        "", "[1, 2", "[1, ?]", "{\"a\": 1}\nx", "{\"a\": \"\\q\"}", "[01]", "[tru]", "{\"a\" 1}", "[1,]",
+        "\"\xc3\"", "\"\xed\xa0\x80\"", "\"\\ud83d\"", "\"a\tb\"",
+    };
+
+    // validate finds the same first error as try_parse, without building nodes, in one piece or byte by byte
+    for (std::string_view text : texts)
+    {
+        auto parsed = ax::Json::try_parse(text);
+        auto error = ax::Json::validate(text);
+        CHECK(parsed.has_value() == !error.has_value());
+        CHECK(ax::Json::is_valid(text) == parsed.has_value());
+        CHECK(valid_bytewise(text) == parsed.has_value());
+        if (error && !parsed)
+        {
+            CHECK(error->kind == parsed.error().kind);
+            CHECK(error->offset == parsed.error().offset);
+            CHECK(error->line == parsed.error().line);
+            CHECK(error->column == parsed.error().column);
+        }
+    }
+
+    // Deep nesting and large documents
+    std::string deep(10000, '[');
+    deep += std::string(10000, ']');
+    CHECK(ax::Json::is_valid(deep));
+    CHECK(!ax::Json::is_valid(deep.substr(1)));
+    std::string large = "[";
+    for (int i = 0; i < 100000; ++i)
+    {
+        large += i ? ",{\"id\":" : "{\"id\":";
+        large += std::to_string(i);
+        large += "}";
+    }
+    large += "]";
+    CHECK(ax::Json::is_valid(large));
+    CHECK(valid_bytewise(large));
+
+    return test::report();
+}
@@ -0,0 +1,76 @@
+#include "json.hpp"
+#include "check.hpp"
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+int main()
+{
+    ax::ThreadPool pool(4);
+
+    // 20000 records in an array, and one object with more members than a range, all of them leaves or records
+    std::vector<ax::Json> records;
+    for (int i = 0; i < 20000; ++i)
+        records.push_back(ax::Json::object_of(ax::member("id", i), ax::member("name", std::string("r").append(std::to_string(i))), ax::member("flag", i % 3 == 0)));
+    ax::Json wide;
+    for (int i = 0; i < 1000; ++i)
+        wide[std::string("k").append(std::to_string(i))] = i;
+    ax::Json doc = {{"records", ax::Json::array(records)}, {"wide", wide}};
+    const size_t leaves = 20000 * 3 + 1000;
+    const long long id_sum = 20000LL * 19999 / 2 + 1000LL * 999 / 2;
+
+    std::atomic<size_t> visited{0};
+    std::atomic<long long> sum{0};
+    doc.for_each_leaf([&](const ax::Json &leaf)
+                      {
+                          ++visited;
+                          if (auto value = leaf.get<int>())
+                              sum += *value; },
+                      pool);
+    CHECK(visited == leaves);
+    CHECK(sum == id_sum);
+
+    CHECK(doc.count_if([](const ax::Json &leaf)
+                       { return leaf.get<bool>().value_or(false); },
+                       pool) == 6667);
+
+    // find_first returns the first hit in document order, and the ranges after it stop early
+    std::atomic<size_t> calls{0};
+    auto first = doc.find_first([&](const ax::Json &leaf)
+                                {
+                                    ++calls;
+                                    return leaf.get<int>().value_or(0) >= 100; },
+                                pool);
+    CHECK(first && first->get<int>() == 100);
+    CHECK(calls < leaves / 2);
+    CHECK(!doc.find_first([](const ax::Json &leaf)
+                          { return leaf.get<int>() == -1; },
+                          pool));
+
+    // transform replaces every leaf
+    ax::Json copy = doc.clone();
+    copy.transform([](const ax::Json &leaf) -> ax::Json
+                   {
+                       if (auto value = leaf.get<int>())
+                           return *value * 2;
+                       return leaf; },
+                   pool);
+    CHECK(copy.at("records").at(123).at("id").get<int>() == 246);
+    CHECK(copy.at("wide").at("k999").get<int>() == 1998);
+    CHECK(copy.at("records").at(123).at("name").get<std::string_view>() == "r123");
+    CHECK(doc.at("records").at(123).at("id").get<int>() == 123);
+
+    // The algorithms can run inside pool tasks, they join their ranges without waiting for a free worker
+    std::atomic<size_t> nested{0};
+    ax::TaskGroup group(pool);
+    for (int i = 0; i < 8; ++i)
+        group.run([&]
+                  { nested += doc.count_if([](const ax::Json &leaf)
+                                           { return leaf.get<bool>().has_value(); },
+                                           pool); });
+    group.wait();
+    CHECK(nested == 8 * 20000);
+
+    return test::report();
+}